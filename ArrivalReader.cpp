@@ -0,0 +1,360 @@
+/*
+ * ArrivalReader.cpp
+ *
+ * Description: Sources of arrival events for the simulation.
+ *              Arrivals are handed out one at a time so the event loop only
+ *              has to keep the next pending arrival in its Priority Queue.
+ *
+ * Class Invariant: next() hands out each arrival of the input exactly once.
+ *                  ChunkSortedArrivalReader hands them out sorted by time,
+ *                  keeping the input order of arrivals with equal times.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <unistd.h>
+#include "ArrivalReader.h"
+#include "InputFormatException.h"
+
+using std::string;
+using std::stringstream;
+using std::ws;
+
+
+// Description: Destructor
+ArrivalReader::~ArrivalReader() { }
+
+// Description: Skips the next count arrivals and returns how many were skipped.
+unsigned long long ArrivalReader::skip(unsigned long long count) {
+    Event skipped;
+    unsigned long long skippedCount = 0;
+    while (skippedCount < count && next(skipped))
+        skippedCount++;
+    return skippedCount;
+}
+
+
+// Description: Constructor
+TextArrivalReader::TextArrivalReader(std::istream &anInput) : input(anInput) { }
+
+// Description: Reads the next "time length" line into newEvent.
+bool TextArrivalReader::next(Event &newEvent) {
+    string aLine = "";
+    int length = 0;
+    int time = 0;
+
+    if (!getline(input >> ws, aLine))
+        return false;
+
+    stringstream ss (aLine);
+    ss >> time >> length;
+    newEvent = Event(Event::ARRIVAL, time, length);
+    return true;
+}
+
+
+// Returns true for the characters ws skips within a line
+static inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Description: Constructor, reads from descriptor (standard input by default).
+FastTextArrivalReader::FastTextArrivalReader(int aDescriptor) : descriptor(aDescriptor) {
+    buffer = new char[BLOCK_SIZE + PADDING];
+    position = end = buffer;
+    memset(buffer, 0, PADDING);
+}
+
+// Description: Destructor
+FastTextArrivalReader::~FastTextArrivalReader() {
+    delete[] buffer;
+}
+
+// Description: Reads the next block, keeping the partial line.
+//              Returns false once the input is exhausted.
+bool FastTextArrivalReader::fill() {
+    unsigned int remaining = end - position;
+    if (remaining == BLOCK_SIZE)
+        throw InputFormatException(lineNumber + 1, "line is too long");
+
+    memmove(buffer, position, remaining);
+    position = buffer;
+    end = buffer + remaining;
+
+    ssize_t bytesRead;
+    do {
+        bytesRead = read(descriptor, buffer + remaining, BLOCK_SIZE - remaining);
+    } while (bytesRead < 0 && errno == EINTR);
+    if (bytesRead < 0)
+        throw std::runtime_error("could not read the input");
+
+    end += bytesRead;
+    memset((char *)end, 0, PADDING);   // Terminates the digit loads of the last number
+    endOfInput = (bytesRead == 0);
+    return !endOfInput;
+}
+
+// Description: Decodes one signed integer starting at cursor and moves cursor past it.
+//              Returns false if there is no integer at cursor or it does not fit in an int.
+bool FastTextArrivalReader::parseInt(const char *&cursor, int &value) const {
+    const char *p = cursor;
+    bool negative = (*p == '-');
+    if (*p == '-' || *p == '+')
+        p++;
+
+    // Classify eight bytes at once: a byte is a digit iff its class is 0x33
+    uint64_t chunk;
+    memcpy(&chunk, p, sizeof(chunk));
+    uint64_t classes = (chunk & 0xF0F0F0F0F0F0F0F0ULL)
+                       | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4);
+    uint64_t nonDigits = classes ^ 0x3333333333333333ULL;
+    unsigned int digits = (nonDigits == 0) ? 8 : __builtin_ctzll(nonDigits) / 8;
+    if (digits == 0)
+        return false;
+
+    // Combine the leading digits pairwise: 8 x 1 digit -> 4 x 2 -> 2 x 4 -> 1 x 8
+    uint64_t number = (chunk - 0x3030303030303030ULL) << (8 * (8 - digits));
+    number = (number * 10 + (number >> 8)) & 0x00FF00FF00FF00FFULL;
+    number = (number * 100 + (number >> 16)) & 0x0000FFFF0000FFFFULL;
+    number = (number * 10000 + (number >> 32)) & 0x00000000FFFFFFFFULL;
+    p += digits;
+
+    // Longer numbers: finish digit by digit, saturating past the int range
+    uint64_t const LIMIT = 2147483648ULL;
+    while (digits == 8 && (unsigned char)(*p - '0') < 10) {
+        number = std::min(number * 10 + (*p - '0'), LIMIT + 1);
+        p++;
+    }
+
+    if (number > LIMIT - (negative ? 0 : 1))
+        return false;
+
+    value = negative ? (int)(0 - number) : (int)number;
+    cursor = p;
+    return true;
+}
+
+// Description: Decodes the next non-blank line, which must hold count integers, into fields.
+//              Returns false at the end of the input.
+bool FastTextArrivalReader::readFields(int fields[], unsigned int count) {
+    while (true) {
+        const char *lineEnd = (const char *)memchr(position, '\n', end - position);
+        if (lineEnd == nullptr) {
+            if (!endOfInput) {
+                fill();
+                continue;
+            }
+            if (position == end)
+                return false;
+            lineEnd = end;      // Last line has no newline
+        }
+        lineNumber++;
+
+        const char *cursor = position;
+        while (cursor < lineEnd && isBlank(*cursor))
+            cursor++;
+        if (cursor == lineEnd) {          // Blank line
+            position = (lineEnd == end) ? end : lineEnd + 1;
+            continue;
+        }
+
+        bool valid = true;
+        for (unsigned int i = 0; valid && i < count; i++) {
+            // Fields are separated by blanks
+            valid = (i == 0 || (cursor < lineEnd && isBlank(*cursor)));
+            while (valid && cursor < lineEnd && isBlank(*cursor))
+                cursor++;
+            valid = valid && parseInt(cursor, fields[i]);
+        }
+        while (valid && cursor < lineEnd && isBlank(*cursor))
+            cursor++;
+
+        if (!valid || cursor != lineEnd) {
+            static char const *const EXPECTED[] = { "\"time length\" as two integers",
+                                                    "\"branch time length\" as three integers",
+                                                    "\"time length teller class\" as four integers" };
+            throw InputFormatException(lineNumber, string("expected ") + EXPECTED[count - 2] + ", got \""
+                                       + string(position, lineEnd - position) + "\"");
+        }
+
+        position = (lineEnd == end) ? end : lineEnd + 1;
+        return true;
+    }
+}
+
+// Description: Reads the next "time length" line into newEvent.
+bool FastTextArrivalReader::next(Event &newEvent) {
+    int fields[2];
+    if (!readFields(fields, 2))
+        return false;
+    newEvent = Event(Event::ARRIVAL, fields[0], fields[1]);
+    return true;
+}
+
+// Description: Reads the next "branch time length" line into branch and newEvent.
+bool FastTextArrivalReader::nextTagged(int &branch, Event &newEvent) {
+    int fields[3];
+    if (!readFields(fields, 3))
+        return false;
+    branch = fields[0];
+    newEvent = Event(Event::ARRIVAL, fields[1], fields[2]);
+    return true;
+}
+
+// Description: Reads the next "time length teller class" line into the four values.
+bool FastTextArrivalReader::nextWithTellerClass(int &time, int &length, int &teller, int &customerClass) {
+    int fields[4];
+    if (!readFields(fields, 4))
+        return false;
+    time = fields[0];
+    length = fields[1];
+    teller = fields[2];
+    customerClass = fields[3];
+    return true;
+}
+
+
+// Description: Constructor, reads every arrival of source.
+ArrivalBuffer::ArrivalBuffer(ArrivalReader &source) {
+    Event newEvent;
+    while (source.next(newEvent))
+        arrivals.push_back(newEvent);
+    arrivals.shrink_to_fit();
+}
+
+// Description: Constructor, takes over someArrivals.
+ArrivalBuffer::ArrivalBuffer(std::vector<Event> &&someArrivals) : arrivals(std::move(someArrivals)) {
+    arrivals.shrink_to_fit();
+}
+
+// Description: Returns the number of arrivals.
+size_t ArrivalBuffer::getElementCount() const {
+    return arrivals.size();
+}
+
+// Description: Returns arrival i.
+const Event & ArrivalBuffer::at(size_t i) const {
+    return arrivals[i];
+}
+
+
+// Description: Constructor
+BufferedArrivalReader::BufferedArrivalReader(const ArrivalBuffer &aBuffer, double aServiceScale)
+    : buffer(aBuffer), serviceScale(aServiceScale) { }
+
+// Description: Reads the next arrival into newEvent.
+bool BufferedArrivalReader::next(Event &newEvent) {
+    if (nextArrival == buffer.getElementCount())
+        return false;
+
+    newEvent = buffer.at(nextArrival++);
+    if (serviceScale != 1.0)
+        newEvent.setLength((int)std::lround(newEvent.getLength() * serviceScale));
+    return true;
+}
+
+// Description: Skips the next count arrivals.
+unsigned long long BufferedArrivalReader::skip(unsigned long long count) {
+    count = std::min<unsigned long long>(count, buffer.getElementCount() - nextArrival);
+    nextArrival += count;
+    return count;
+}
+
+
+// Description: Comparison <= operator, ties are broken by run so
+//              arrivals with equal times keep their input order.
+bool ChunkSortedArrivalReader::RunHead::operator<=(const RunHead &rhs) const {
+    if (time == rhs.time)
+        return run <= rhs.run;
+    return time < rhs.time;
+}
+
+// Description: Constructor, reads and sorts the whole source.
+ChunkSortedArrivalReader::ChunkSortedArrivalReader(ArrivalReader &source, unsigned int chunkSize) {
+    Event newEvent;
+    bool more = true;
+
+    chunk.reserve(chunkSize);
+    while (more) {
+        while (chunk.size() < chunkSize && (more = source.next(newEvent)))
+            chunk.push_back(newEvent);
+
+        std::stable_sort(chunk.begin(), chunk.end(), [](const Event &lhs, const Event &rhs) {
+            return lhs.getTime() < rhs.getTime();
+        });
+
+        // The whole input fits in one chunk: serve it straight from memory
+        if (!more && runs.empty())
+            return;
+        spill();
+    }
+
+    // Prime the merge with the first arrival of every run
+    for (unsigned int run = 0; run < runs.size(); run++) {
+        RunHead head;
+        rewind(runs[run]);
+        if (readRun(run, head))
+            runHeads.insert(head);
+    }
+}
+
+// Description: Destructor, closes (and thereby deletes) the temporary runs.
+ChunkSortedArrivalReader::~ChunkSortedArrivalReader() {
+    for (unsigned int run = 0; run < runs.size(); run++)
+        fclose(runs[run]);
+}
+
+// Description: Writes the sorted chunk out as a run.
+void ChunkSortedArrivalReader::spill() {
+    FILE *file = tmpfile();
+    if (file == nullptr)
+        throw std::runtime_error("could not create a temporary file to sort the input");
+
+    for (unsigned int i = 0; i < chunk.size(); i++) {
+        int record[2] = { chunk[i].getTime(), chunk[i].getLength() };
+        if (fwrite(record, sizeof(record), 1, file) != 1)
+            throw std::runtime_error("could not write a sorted run to a temporary file");
+    }
+    runs.push_back(file);
+    chunk.clear();
+}
+
+// Description: Reads the next arrival of a run.
+bool ChunkSortedArrivalReader::readRun(unsigned int run, RunHead &head) {
+    int record[2];
+    if (fread(record, sizeof(record), 1, runs[run]) != 1)
+        return false;
+
+    head.time = record[0];
+    head.length = record[1];
+    head.run = run;
+    return true;
+}
+
+// Description: Reads the next arrival in time order into newEvent.
+bool ChunkSortedArrivalReader::next(Event &newEvent) {
+    if (runs.empty()) {
+        if (chunkIndex == chunk.size())
+            return false;
+        newEvent = chunk[chunkIndex++];
+        return true;
+    }
+
+    if (runHeads.getElementCount() == 0)
+        return false;
+
+    RunHead head = runHeads.pop();
+    newEvent = Event(Event::ARRIVAL, head.time, head.length);
+
+    // Refill the merge from the run the arrival came from
+    if (readRun(head.run, head))
+        runHeads.insert(head);
+    return true;
+}
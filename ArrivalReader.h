@@ -0,0 +1,186 @@
+/*
+ * ArrivalReader.h
+ *
+ * Description: Sources of arrival events for the simulation.
+ *              Arrivals are handed out one at a time so the event loop only
+ *              has to keep the next pending arrival in its Priority Queue.
+ *
+ * Class Invariant: next() hands out each arrival of the input exactly once.
+ *                  ChunkSortedArrivalReader hands them out sorted by time,
+ *                  keeping the input order of arrivals with equal times.
+ */
+
+#ifndef ARRIVAL_READER_H
+#define ARRIVAL_READER_H
+
+#include <cstdio>
+#include <istream>
+#include <vector>
+#include "Event.h"
+#include "BinaryHeap.h"
+
+class ArrivalReader {
+
+    public:
+        // Description: Destructor
+        virtual ~ArrivalReader();
+
+        // Description: Reads the next arrival into newEvent.
+        //              Returns true if an arrival was read, false at the end of the input.
+        virtual bool next(Event &newEvent) = 0;
+
+        // Description: Skips the next count arrivals (e.g. those a checkpointed run had
+        //              read) and returns how many were skipped, fewer only at the end.
+        // Time Efficiency: O(count) by default, O(1) where the arrivals are in memory
+        virtual unsigned long long skip(unsigned long long count);
+};
+
+
+// Reads "time length" lines from a text stream, one line per arrival.
+class TextArrivalReader : public ArrivalReader {
+
+    private:
+        std::istream &input;
+
+    public:
+        // Description: Constructor
+        TextArrivalReader(std::istream &anInput);
+
+        // Description: Reads the next "time length" line into newEvent.
+        bool next(Event &newEvent);
+};
+
+
+// Reads "time length" lines from a file descriptor in large blocks and decodes
+// them with a hand-rolled integer parser (eight digits at a time) instead of
+// a stringstream per line. Produces the same arrivals as TextArrivalReader on
+// valid input, but rejects malformed lines instead of reading them as zeros.
+class FastTextArrivalReader : public ArrivalReader {
+
+    private:
+        static unsigned int const BLOCK_SIZE = 1 << 20;   // Bytes read from the input at a time
+        static unsigned int const PADDING = 8;            // Readable bytes past the data for 8-byte loads
+
+        int descriptor;
+        char *buffer;
+        const char *position;              // Start of the next unparsed line
+        const char *end;                   // End of the data in buffer
+        bool endOfInput = false;
+        unsigned long long lineNumber = 0;
+
+        bool fill();                                           // Reads the next block, keeping the partial line
+        bool parseInt(const char *&cursor, int &value) const;  // Decodes one signed integer
+        bool readFields(int fields[], unsigned int count);     // Decodes the next line of count integers
+
+    public:
+        // Description: Constructor, reads from descriptor (standard input by default).
+        FastTextArrivalReader(int aDescriptor = 0);
+
+        // Description: Destructor
+        ~FastTextArrivalReader();
+
+        // Description: Reads the next "time length" line into newEvent.
+        // Exceptions: Throws InputFormatException if the line is malformed
+        //             and runtime_error if the input cannot be read.
+        bool next(Event &newEvent);
+
+        // Description: Reads the next "branch time length" line (a trace tagged with the
+        //              branch of every arrival) into branch and newEvent.
+        //              Returns true if an arrival was read, false at the end of the input.
+        // Exceptions: Throws InputFormatException if the line is malformed
+        //             and runtime_error if the input cannot be read.
+        bool nextTagged(int &branch, Event &newEvent);
+
+        // Description: Reads the next "time length teller class" line (a trace with the
+        //              teller and customer class of every arrival) into the four values.
+        //              Returns true if an arrival was read, false at the end of the input.
+        // Exceptions: Throws InputFormatException if the line is malformed
+        //             and runtime_error if the input cannot be read.
+        bool nextWithTellerClass(int &time, int &length, int &teller, int &customerClass);
+};
+
+
+// All arrivals of a source, read once and held in memory so that any number of
+// BufferedArrivalReaders (e.g. the runs of a parameter sweep) can share them.
+// The buffer is not modified after construction, so concurrent readers are safe.
+class ArrivalBuffer {
+
+    private:
+        std::vector<Event> arrivals;
+
+    public:
+        // Description: Constructor, reads every arrival of source.
+        ArrivalBuffer(ArrivalReader &source);
+
+        // Description: Constructor, takes over someArrivals.
+        ArrivalBuffer(std::vector<Event> &&someArrivals);
+
+        // Description: Returns the number of arrivals.
+        size_t getElementCount() const;
+
+        // Description: Returns arrival i.
+        // Precondition: i < getElementCount()
+        const Event &at(size_t i) const;
+};
+
+
+// Hands out the arrivals of an ArrivalBuffer, with their lengths scaled by serviceScale.
+class BufferedArrivalReader : public ArrivalReader {
+
+    private:
+        const ArrivalBuffer &buffer;
+        double serviceScale;
+        size_t nextArrival = 0;
+
+    public:
+        // Description: Constructor
+        BufferedArrivalReader(const ArrivalBuffer &aBuffer, double aServiceScale = 1.0);
+
+        // Description: Reads the next arrival into newEvent.
+        bool next(Event &newEvent);
+
+        // Description: Skips the next count arrivals.
+        // Time Efficiency: O(1)
+        unsigned long long skip(unsigned long long count);
+};
+
+
+// Sorts the arrivals of an unsorted source in bounded memory.
+// The source is read in chunks of at most chunkSize arrivals. Each chunk is sorted
+// and, unless the whole input fits in a single chunk, spilled to a temporary file
+// as a sorted run. The runs are then merged while the simulation consumes them.
+class ChunkSortedArrivalReader : public ArrivalReader {
+
+    private:
+        // Head (smallest remaining arrival) of one sorted run during the merge.
+        struct RunHead {
+            int time;
+            int length;
+            unsigned int run;
+
+            // Description: Comparison <= operator, ties are broken by run so
+            //              arrivals with equal times keep their input order.
+            bool operator<=(const RunHead &rhs) const;
+        };
+
+        std::vector<Event> chunk;          // Sorted chunk served from memory (single chunk inputs)
+        unsigned int chunkIndex = 0;       // Next arrival to hand out from chunk
+        std::vector<FILE*> runs;           // Sorted runs spilled to temporary files
+        BinaryHeap<RunHead> runHeads;      // Smallest remaining arrival of every run
+
+        void spill();                                  // Writes the sorted chunk out as a run
+        bool readRun(unsigned int run, RunHead &head); // Reads the next arrival of a run
+
+    public:
+        static unsigned int const DEFAULT_CHUNK_SIZE = 1 << 20;   // Arrivals per in-memory chunk
+
+        // Description: Constructor, reads and sorts the whole source.
+        ChunkSortedArrivalReader(ArrivalReader &source, unsigned int chunkSize = DEFAULT_CHUNK_SIZE);
+
+        // Description: Destructor, closes (and thereby deletes) the temporary runs.
+        ~ChunkSortedArrivalReader();
+
+        // Description: Reads the next arrival in time order into newEvent.
+        bool next(Event &newEvent);
+};
+#endif
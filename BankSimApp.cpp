@@ -1,130 +1,422 @@
 /*
  * BankSimApp.cpp
  * 
- * Class Description: Simulates a line up with one teller.
+ * Class Description: Simulates a line up with one or more tellers
+ *					  (see Simulation for the line disciplines).
  *					  Calculates the average wait time for each customer.
  *					  Also outputs the number of customers and the time of each
  *					  customer's arrival/departure in order.
+ *					  Arrivals are streamed from the input, which is expected to be
+ *					  sorted by time (see --unsorted otherwise).
+ *					  A long run can take checkpoints, stop on SIGINT or SIGTERM at
+ *					  the next one, and be resumed from it (see Checkpoint.h).
+ *					  A run can also be edited afterwards, customer by customer, each
+ *					  edit re-simulating only what it changes (see WhatIfSimulation).
  *
  * Author: Vansh Thakur Rana (vtr) & Agrim Joshi (aja121)
  * Last Modification: Apr. 2024
  */
 
 #include <iostream>
+#include <fstream>
 #include <string>
+#include <csignal>
+#include <cstdlib>
+#include <stdexcept>
 #include <sstream>
-#include <iomanip>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "Event.h"
-#include "Queue.h"
-#include "PriorityQueue.h"
-#include "BinaryHeap.h"
-
-#include "EmptyDataCollectionException.h"
+#include "ArrivalReader.h"
+#include "BinaryTrace.h"
+#include "TraceLog.h"
+#include "Simulation.h"
+#include "Checkpoint.h"
+#include "ParameterSweep.h"
+#include "ShardedSimulation.h"
+#include "WhatIfSimulation.h"
+#include "IntervalMetrics.h"
+#include "Instrumentation.h"
 
 using namespace std;
 
-int sum = 0;   // To store the sum of wait time
-
-// Processes an arrival event
-void processArrival (Event& arrivalEvent, PriorityQueue<Event>& eventPriorityQueue, Queue<Event>& bankLine, int& currentTime, bool& tellerAvailable) {
-    cout << "Processing an arrival event at time:" << setw(6) << right << currentTime << endl;
-    // Remove this event from the event queue
-    eventPriorityQueue.dequeue();
-    int departureTime;
-    if (bankLine.isEmpty() && tellerAvailable) {
-        departureTime = currentTime + arrivalEvent.getLength();
-        Event departureEvent = Event('D', departureTime);
-        eventPriorityQueue.enqueue(departureEvent);
-        tellerAvailable = false;
-    }
-    else {
-        bankLine.enqueue(arrivalEvent);
+unsigned int const DEFAULT_SAMPLE_EVERY = 1000;   // Sampled output: one event logged out of this many
+int const DEFAULT_INTERVAL_WIDTH = 900;           // Interval metrics: time units per interval
+
+// Splits a comma separated list such as "1,2,4" into its values.
+// Returns false if an item is not a positive number.
+template <class ValueType>
+bool parseList(const string &list, vector<ValueType> &values) {
+    stringstream ss (list);
+    string item;
+    while (getline(ss, item, ',')) {
+        stringstream itemStream (item);
+        ValueType value;
+        if (!(itemStream >> value) || !itemStream.eof() || !(value > 0))
+            return false;
+        values.push_back(value);
     }
+    return !values.empty();
 }
 
-// Processes a departure event
-void processDeparture (Event& departureEvent, PriorityQueue<Event>& eventPriorityQueue, Queue<Event>& bankLine, int& currentTime, bool& tellerAvailable) {
-    cout << "Processing a departure event at time:" << setw(5) << right << currentTime << endl;
-    // Remove this event from the event queue
-    eventPriorityQueue.dequeue();
-
-    int departureTime;
+// Runs arrivals through the event driven engine and returns true if it gives
+// exactly the customer count and statistics simulation gave.
+bool crossCheck(const Simulation &simulation, const ArrivalBuffer &arrivals, unsigned int numberOfTellers,
+                Simulation::LineDiscipline discipline, Simulation::Scheduler scheduler) {
+    unique_ptr<Simulation> reference(Simulation::createEventDriven(numberOfTellers, discipline, scheduler));
+    BufferedArrivalReader reader(arrivals);
+    ostringstream unused;
+    TraceLog quiet(unused, TraceLog::SUMMARY);
+    reference->run(reader, quiet);
+    return reference->getCustomerCount() == simulation.getCustomerCount()
+           && reference->getStatistics() == simulation.getStatistics();
+}
 
-    if (!bankLine.isEmpty()){
+// Applies one line of a what-if file to whatIf:
+//     length CUSTOMER LENGTH    new transaction length of customer CUSTOMER (from 1)
+//     insert TIME LENGTH        a new customer arriving at TIME
+//     remove CUSTOMER           customer CUSTOMER never comes
+// Returns false if the line is none of these.
+bool applyEdit(WhatIfSimulation &whatIf, const string &edit) {
+    stringstream editStream (edit);
+    string command;
+    long long first, second;
+    if (!(editStream >> command >> first))
+        return false;
+    if (command == "remove" && editStream.eof() && first > 0)
+        whatIf.removeArrival(first - 1);
+    else if (command == "length" && editStream >> second && editStream.eof() && first > 0)
+        whatIf.setLength(first - 1, second);
+    else if (command == "insert" && editStream >> second && editStream.eof())
+        whatIf.insertArrival(first, second);
+    else
+        return false;
+    return true;
+}
 
-        try {
-            // Customer at front of line begins transaction
-            Event customer = bankLine.peek();
-            sum = sum + currentTime - customer.getTime();
-            bankLine.dequeue();
-            departureTime = currentTime + customer.getLength();
-            Event newDepartureEvent = Event('D', departureTime);
-            eventPriorityQueue.enqueue(newDepartureEvent);
-        } catch (EmptyDataCollectionException& exception) {
-            cout << exception.what() << endl;
-        }
+// Stops the run at its next arrival, once it has written a checkpoint
+void stopAtCheckpoint(int) {
+    Checkpointer::requestStop();
+}
 
-    } else
-        tellerAvailable = true;
+// Prints how to call the simulator
+void printUsage(const char *program) {
+    cerr << "Usage: " << program << " [options] < input" << endl;
+    cerr << "    --unsorted            Input is not sorted by arrival time; sort it in bounded chunks first" << endl;
+    cerr << "    --binary FILE         Read arrivals from a binary trace (see bsimconv) instead of standard input" << endl;
+    cerr << "    --output MODE         full (every event, default), sampled (every n-th event) or summary (statistics only)" << endl;
+    cerr << "    --sample-every N      Log one event out of N in sampled mode (default " << DEFAULT_SAMPLE_EVERY << ")" << endl;
+    cerr << "    --tellers N           Number of tellers (default 1)" << endl;
+    cerr << "    --line KIND           shared (one line for all tellers, default) or shortest (one line" << endl;
+    cerr << "                          per teller, customers join the teller with the fewest customers)" << endl;
+    cerr << "    --scheduler KIND      Event queue: binary (binary heap, default), 4ary (4-ary heap), calendar (calendar queue)" << endl;
+    cerr << "                          or soa (binary heap of packed keys and bank lines stored as arrays of fields)" << endl;
+    cerr << "    --engine KIND         auto (default: without an event queue for a single teller, see LindleySimulation)" << endl;
+    cerr << "                          or event (always the event driven engine)" << endl;
+    cerr << "    --crosscheck          Also run the input through the event driven engine and check the statistics are identical" << endl;
+    cerr << "    --parallel            Single teller: scan the run in parallel, chunk by chunk, on --threads threads" << endl;
+    cerr << "                          (--output summary only, no intervals or sweep; see LindleySimulation)" << endl;
+    cerr << "    --sweep-tellers LIST  Parameter sweep: simulate each teller count of LIST (e.g. 1,2,4)" << endl;
+    cerr << "    --sweep-scale LIST    Parameter sweep: simulate each transaction length scaling of LIST (e.g. 0.9,1,1.1)" << endl;
+    cerr << "    --by-branch           Input lines are \"branch time length\": simulate every branch on its own, in parallel," << endl;
+    cerr << "                          and merge their statistics into regional ones (text input only, no sweep)" << endl;
+    cerr << "    --threads N           Threads running the sweep, the branches or the parallel scan (default: one per core)" << endl;
+    cerr << "    --checkpoint FILE     Write a checkpoint of the run to FILE every --checkpoint-every customers;" << endl;
+    cerr << "                          on SIGINT or SIGTERM, write one and stop (no sweep, branches, parallel scan or intervals)" << endl;
+    cerr << "    --checkpoint-every N  Customers between two checkpoints (default " << Checkpointer::DEFAULT_EVERY << ")" << endl;
+    cerr << "    --resume FILE         Resume the run checkpointed in FILE, given the same input and options" << endl;
+    cerr << "    --what-if FILE        Then apply the edits of FILE one by one (\"length CUSTOMER LENGTH\", \"insert TIME LENGTH\"" << endl;
+    cerr << "                          or \"remove CUSTOMER\"), printing the statistics after each; an edit re-simulates" << endl;
+    cerr << "                          from the last snapshot before it until the run reconverges (--output summary only," << endl;
+    cerr << "                          no sweep, branches, parallel scan, checkpoints or intervals)" << endl;
+    cerr << "    --snapshot-every N    What-if: arrivals between two snapshots (default " << WhatIfSimulation::DEFAULT_SNAPSHOT_EVERY << ")" << endl;
+    cerr << "    --intervals FILE      Write arrivals, departures, waits and line lengths of every interval to FILE" << endl;
+    cerr << "    --interval-width N    Time units per interval (default " << DEFAULT_INTERVAL_WIDTH << ")" << endl;
+    cerr << "    --interval-format F   csv (default) or binary (see IntervalMetrics.h)" << endl;
 }
 
 
-int main() {
-    // Simulation Begins
-    cout << "Simulation Begins" << endl;
-
-    int currentTime = 0;
-    Queue<Event> bankLine = Queue<Event>();           // Bank Line
-    PriorityQueue<Event> eventPriorityQueue = PriorityQueue<Event>();   // Event Queue
-
-    bool tellerAvailable = true;
-    int customerCount = 0;        // Number of customers
-    
-    string aLine = "";
-    int length = 0;
-    int time = 0;
-    Event newArrivalEvent;             // Arrival Event
-
-    // Add arrival events to the event queue
-    while (getline(cin >> ws, aLine)) {
-        stringstream ss (aLine);                     // Read from the input file
-        ss >> time >> length;
-        newArrivalEvent.setLength(length);           // Set length of transaction time for a customer
-        newArrivalEvent.setTime(time);               // Set required transaction time for a customer
-
-        if (!eventPriorityQueue.enqueue(newArrivalEvent)) {
+int main(int argc, char *argv[]) {
+    bool sortedInput = true;      // Stream arrivals straight from the input
+    string binaryTrace = "";      // Binary trace to read instead of standard input
+    TraceLog::Mode outputMode = TraceLog::FULL;
+    unsigned int sampleEvery = DEFAULT_SAMPLE_EVERY;
+    unsigned int numberOfTellers = 1;
+    Simulation::LineDiscipline discipline = Simulation::SHARED_LINE;
+    Simulation::Scheduler scheduler = Simulation::BINARY_HEAP;
+    vector<unsigned int> sweepTellers;     // Parameter sweep: teller counts
+    vector<double> sweepScales;            // Parameter sweep: transaction length scalings
+    bool byBranch = false;                 // Input tagged by branch, simulated branch by branch
+    bool eventDriven = false;              // Never take the analytic fast path
+    bool crosscheck = false;               // Compare with the event driven engine
+    bool crosscheckPassed = true;
+    bool parallel = false;                 // Let a single teller run scan its arrivals in parallel
+    string checkpointFile = "";            // Checkpoints: where to write them
+    long long checkpointEvery = Checkpointer::DEFAULT_EVERY;
+    string resumeFile = "";                // Checkpoint to resume the run from
+    string whatIfFile = "";                // Edits to apply to the run, one per line
+    size_t snapshotEvery = WhatIfSimulation::DEFAULT_SNAPSHOT_EVERY;
+    unsigned int numberOfThreads = thread::hardware_concurrency();
+    string intervalFile = "";              // Interval metrics: where to write them
+    int intervalWidth = DEFAULT_INTERVAL_WIDTH;
+    bool binaryIntervals = false;
+
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--unsorted")
+            sortedInput = false;
+        else if (option == "--binary" && i + 1 < argc)
+            binaryTrace = argv[++i];
+        else if (option == "--output" && i + 1 < argc && string(argv[i + 1]) == "full")
+            outputMode = TraceLog::FULL, i++;
+        else if (option == "--output" && i + 1 < argc && string(argv[i + 1]) == "sampled")
+            outputMode = TraceLog::SAMPLED, i++;
+        else if (option == "--output" && i + 1 < argc && string(argv[i + 1]) == "summary")
+            outputMode = TraceLog::SUMMARY, i++;
+        else if (option == "--sample-every" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            sampleEvery = atoi(argv[++i]);
+        else if (option == "--tellers" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            numberOfTellers = atoi(argv[++i]);
+        else if (option == "--line" && i + 1 < argc && string(argv[i + 1]) == "shared")
+            discipline = Simulation::SHARED_LINE, i++;
+        else if (option == "--line" && i + 1 < argc && string(argv[i + 1]) == "shortest")
+            discipline = Simulation::SHORTEST_LINE, i++;
+        else if (option == "--scheduler" && i + 1 < argc && string(argv[i + 1]) == "binary")
+            scheduler = Simulation::BINARY_HEAP, i++;
+        else if (option == "--scheduler" && i + 1 < argc && string(argv[i + 1]) == "4ary")
+            scheduler = Simulation::QUATERNARY_HEAP, i++;
+        else if (option == "--scheduler" && i + 1 < argc && string(argv[i + 1]) == "calendar")
+            scheduler = Simulation::CALENDAR_QUEUE, i++;
+        else if (option == "--scheduler" && i + 1 < argc && string(argv[i + 1]) == "soa")
+            scheduler = Simulation::STRUCTURE_OF_ARRAYS, i++;
+        else if (option == "--sweep-tellers" && i + 1 < argc && parseList(argv[i + 1], sweepTellers))
+            i++;
+        else if (option == "--sweep-scale" && i + 1 < argc && parseList(argv[i + 1], sweepScales))
+            i++;
+        else if (option == "--engine" && i + 1 < argc && string(argv[i + 1]) == "auto")
+            eventDriven = false, i++;
+        else if (option == "--engine" && i + 1 < argc && string(argv[i + 1]) == "event")
+            eventDriven = true, i++;
+        else if (option == "--crosscheck")
+            crosscheck = true;
+        else if (option == "--parallel")
+            parallel = true;
+        else if (option == "--by-branch")
+            byBranch = true;
+        else if (option == "--threads" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            numberOfThreads = atoi(argv[++i]);
+        else if (option == "--checkpoint" && i + 1 < argc)
+            checkpointFile = argv[++i];
+        else if (option == "--checkpoint-every" && i + 1 < argc && atoll(argv[i + 1]) > 0)
+            checkpointEvery = atoll(argv[++i]);
+        else if (option == "--resume" && i + 1 < argc)
+            resumeFile = argv[++i];
+        else if (option == "--what-if" && i + 1 < argc)
+            whatIfFile = argv[++i];
+        else if (option == "--snapshot-every" && i + 1 < argc && atoll(argv[i + 1]) > 0)
+            snapshotEvery = atoll(argv[++i]);
+        else if (option == "--intervals" && i + 1 < argc)
+            intervalFile = argv[++i];
+        else if (option == "--interval-width" && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            intervalWidth = atoi(argv[++i]);
+        else if (option == "--interval-format" && i + 1 < argc && string(argv[i + 1]) == "csv")
+            binaryIntervals = false, i++;
+        else if (option == "--interval-format" && i + 1 < argc && string(argv[i + 1]) == "binary")
+            binaryIntervals = true, i++;
+        else {
+            printUsage(argv[0]);
             return 1;
         }
     }
-    customerCount = eventPriorityQueue.getElementCount();       // Set customer count from input file
 
-    // Event Loop
-    while (!eventPriorityQueue.isEmpty()) {
-        try {
-            Event newEvent = eventPriorityQueue.peek();
-            // Get current time
-            currentTime = newEvent.getTime();
+    if (numberOfThreads == 0)
+        numberOfThreads = 1;
+    bool sweeping = !sweepTellers.empty() || !sweepScales.empty();
+    if ((byBranch && (sweeping || !binaryTrace.empty())) || (crosscheck && (sweeping || byBranch))
+        || (parallel && (sweeping || byBranch || outputMode != TraceLog::SUMMARY || !intervalFile.empty()))
+        || ((!checkpointFile.empty() || !resumeFile.empty())
+            && (sweeping || byBranch || crosscheck || parallel || !intervalFile.empty()))
+        || (!whatIfFile.empty() && (sweeping || byBranch || crosscheck || parallel || outputMode != TraceLog::SUMMARY
+                                    || !checkpointFile.empty() || !resumeFile.empty() || !intervalFile.empty()))) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (sweepTellers.empty())
+        sweepTellers.push_back(numberOfTellers);
+    if (sweepScales.empty())
+        sweepScales.push_back(1.0);
+
+    // Simulation Begins
+    if (!sweeping && !byBranch)
+        cout << (resumeFile.empty() ? "Simulation Begins" : "Simulation Resumes") << endl;
+
+    // Declared before the simulation, which refers to them, so they outlive it
+    unique_ptr<Checkpointer> checkpointer;
+    unique_ptr<IntervalSink> intervalSink;
+    unique_ptr<IntervalMetrics> intervals;
+
+    // The sweep, the branches and the what-if run build their own simulations
+    unique_ptr<Simulation> simulation;
+    if (!sweeping && !byBranch && whatIfFile.empty()) {
+        simulation.reset(eventDriven ? Simulation::createEventDriven(numberOfTellers, discipline, scheduler)
+                                     : Simulation::create(numberOfTellers, discipline, scheduler));
+        if (parallel)
+            simulation->setThreadCount(numberOfThreads);
+        if (!checkpointFile.empty()) {
+            checkpointer.reset(new Checkpointer(checkpointFile, checkpointEvery));
+            simulation->setCheckpointer(checkpointer.get());
+            signal(SIGINT, stopAtCheckpoint);
+            signal(SIGTERM, stopAtCheckpoint);
+        }
+    }
+    TraceLog traceLog(cout, outputMode, sampleEvery);
 
-            if (newEvent.getType() == Event::ARRIVAL) {
-                // Call the Arrival process function
-                processArrival(newEvent, eventPriorityQueue, bankLine, currentTime, tellerAvailable);
+    // Arrivals are streamed from the input: only the next pending arrival is kept
+    // in the event queue, together with the outstanding departures.
+    FastTextArrivalReader textReader;
+    ArrivalReader *arrivals = &textReader;
+    unique_ptr<MappedTraceReader> traceReader;
+    unique_ptr<ChunkSortedArrivalReader> sortedReader;
+    unique_ptr<WhatIfSimulation> whatIf;
+    vector<string> edits;
+
+    try {
+        {   // Setup: the interval metrics and the input
+            BSIM_PHASE(SETUP);
+            if (!intervalFile.empty() && simulation != nullptr) {
+                if (binaryIntervals)
+                    intervalSink.reset(new BinaryIntervalSink(intervalFile));
+                else
+                    intervalSink.reset(new CsvIntervalSink(intervalFile));
+                intervals.reset(new IntervalMetrics(intervalWidth, *intervalSink));
+                simulation->setIntervalMetrics(intervals.get());
+            }
+            if (!binaryTrace.empty()) {
+                traceReader.reset(new MappedTraceReader(binaryTrace));
+                arrivals = traceReader.get();
+            }
+            if (!sortedInput && !byBranch) {      // Branches are sorted one by one once partitioned
+                sortedReader.reset(new ChunkSortedArrivalReader(*arrivals));
+                arrivals = sortedReader.get();
             }
-            else {
-                // Call the Departure process function
-                processDeparture(newEvent, eventPriorityQueue, bankLine, currentTime, tellerAvailable);
+            if (!resumeFile.empty())
+                simulation->resume(resumeFile, *arrivals);
+            if (!whatIfFile.empty()) {
+                ifstream editFile(whatIfFile);
+                if (!editFile)
+                    throw runtime_error("could not open " + whatIfFile);
+                string edit;
+                while (getline(editFile, edit))
+                    if (edit.find_first_not_of(" \t\r") != string::npos)
+                        edits.push_back(edit);
+                whatIf.reset(new WhatIfSimulation(numberOfTellers, discipline, scheduler, eventDriven, snapshotEvery));
+            }
+        }
+
+        if (sweeping) {
+            // Parse the input once, then simulate every combination of the parameters
+            ArrivalBuffer arrivalBuffer(*arrivals);
+            ParameterSweep sweep(arrivalBuffer, discipline, scheduler);
+            for (unsigned int t = 0; t < sweepTellers.size(); t++)
+                for (unsigned int s = 0; s < sweepScales.size(); s++)
+                    sweep.addRun(sweepTellers[t], sweepScales[s]);
+
+            sweep.run(numberOfThreads);
+            cout << "Parameter Sweep: " << sweep.getRuns().size() << " runs over "
+                 << arrivalBuffer.getElementCount() << " arrivals" << endl;
+            cout << endl;
+            sweep.printTable(cout);
+        }
+        else if (byBranch) {
+            // Partition the input by branch, then simulate the branches in parallel
+            ShardedSimulation sharded(numberOfTellers, discipline, scheduler);
+            {
+                BSIM_PHASE(SETUP);
+                sharded.partition(textReader, !sortedInput);
             }
+            sharded.run(numberOfThreads);
+
+            BSIM_PHASE(SUMMARY);
+            cout << "Branch Simulation: " << sharded.getBranches().size() << " branches, "
+                 << sharded.getArrivalCount() << " arrivals" << endl;
+            cout << endl;
+            sharded.printTable(cout);
+            cout << endl;
+            cout << "Regional Statistics: " << endl;
+            cout << endl;
+            cout << "    Total number of people processed: " << sharded.getCustomerCount() << endl;
+            cout << "    Average amount of time spent waiting: " << float(sharded.getTotalWait())/float(sharded.getCustomerCount()) << endl;
+            sharded.getStatistics().print(cout);
         }
-        catch (EmptyDataCollectionException & anException) {
-            cout << anException.what() << endl;
+        else if (crosscheck) {
+            // Keep the arrivals, to run them through the event driven engine as well
+            ArrivalBuffer arrivalBuffer(*arrivals);
+            BufferedArrivalReader reader(arrivalBuffer);
+            simulation->run(reader, traceLog);
+            crosscheckPassed = crossCheck(*simulation, arrivalBuffer, numberOfTellers, discipline, scheduler);
         }
+        else if (whatIf != nullptr)
+            whatIf->run(*arrivals);
+        else
+            simulation->run(*arrivals, traceLog);
+
+        if (intervalSink != nullptr)
+            intervalSink->close();
+        if (checkpointer != nullptr)
+            checkpointer->finish();
+    }
+    catch (runtime_error & anException) {
+        // Unreadable or malformed input
+        traceLog.flush();
+        cout.flush();
+        cerr << anException.what() << endl;
+        return 1;
+    }
+    if (sweeping || byBranch)
+        return 0;
+    if (simulation != nullptr && simulation->isStopped()) {
+        cout << "Simulation Stopped after " << simulation->getCustomerCount() << " customers: resume with --resume "
+             << checkpointer->getFileName() << endl;
+        return 1;
     }
 
-    cout << "Simulation Ends" << endl;
-    cout << endl;
-    cout << "Final Statistics: " << endl;
-    cout << endl;
-    cout << "    Total number of people processed: " << customerCount << endl;
-    cout << "    Average amount of time spent waiting: " << float(sum)/float(customerCount) << endl;
+    {
+        BSIM_PHASE(SUMMARY);
+        long long customerCount = whatIf != nullptr ? whatIf->getCustomerCount() : simulation->getCustomerCount();
+        long long totalWait = whatIf != nullptr ? whatIf->getTotalWait() : simulation->getTotalWait();
+        cout << "Simulation Ends" << endl;
+        cout << endl;
+        cout << "Final Statistics: " << endl;
+        cout << endl;
+        cout << "    Total number of people processed: " << customerCount << endl;
+        cout << "    Average amount of time spent waiting: " << float(totalWait)/float(customerCount) << endl;
+        (whatIf != nullptr ? whatIf->getStatistics() : simulation->getStatistics()).print(cout);
+        if (crosscheck)
+            cout << "    Cross-check against the event driven engine: "
+                 << (crosscheckPassed ? "identical" : "DIFFERENT") << endl;
+    }
+
+    // What-if: each edit on top of the ones before it
+    for (size_t e = 0; e < edits.size(); e++) {
+        try {
+            if (!applyEdit(*whatIf, edits[e]))
+                throw runtime_error("malformed edit \"" + edits[e] + "\" in " + whatIfFile);
+        }
+        catch (runtime_error & anException) {
+            cerr << anException.what() << endl;
+            return 1;
+        }
+        BSIM_PHASE(SUMMARY);
+        cout << endl;
+        cout << "What-if: " << edits[e] << " (re-simulated " << whatIf->getResimulatedCount() << " customers"
+             << (whatIf->hasReconverged() ? ", then reconverged" : "") << ")" << endl;
+        cout << endl;
+        cout << "    Total number of people processed: " << whatIf->getCustomerCount() << endl;
+        cout << "    Average amount of time spent waiting: " << float(whatIf->getTotalWait())/float(whatIf->getCustomerCount()) << endl;
+        whatIf->getStatistics().print(cout);
+    }
+    Instrumentation::print(cout);     // Nothing unless built with BSIM_INSTRUMENT
 
-    return 0;
+    return crosscheckPassed ? 0 : 1;
 }
\ No newline at end of file
@@ -2,8 +2,14 @@
  * BinaryHeap.cpp
  *
  * Description: Min Binary Heap ADT class.
+ *              Compare(a, b) is true when a may come out of the heap before b
+ *              (HeapOrder<ElementType>, i.e. a <= b, by default).
+ *              Growth decides when the array is reallocated (see GrowthPolicy.h)
+ *              and Allocator where its memory comes from (e.g. ArenaAllocator).
  *
  * Class Invariant:  Always a Min Binary Heap.
+ *                   elements[0 .. elementCount-1] are constructed, the
+ *                   rest of the array is raw memory.
  * 
  * Author: Vansh Thakur Rana (vtr)
  *         Agrim Joshi (aja121)
@@ -12,44 +18,66 @@
  */  
 
 #include <iostream>
+#include <new>
+#include <utility>
 #include "BinaryHeap.h"  // Header file
-#include <cmath>
+#include "Instrumentation.h"
 
 using std::cout;
 using std::endl;
 
-// Description: Constructor
-template <class ElementType>
-BinaryHeap<ElementType>::BinaryHeap() {
-   elements = new ElementType[INITIAL_CAPACITY];
+// Description: Raw memory for newCapacity elements, none of them constructed
+template <class ElementType, class Compare, class Growth, class Allocator>
+ElementType *BinaryHeap<ElementType, Compare, Growth, Allocator>::allocate(unsigned int newCapacity) {
+   return std::allocator_traits<Allocator>::allocate(allocator, newCapacity);
+}
+
+// Description: Gives the memory of an array of someCapacity elements back to the allocator
+template <class ElementType, class Compare, class Growth, class Allocator>
+void BinaryHeap<ElementType, Compare, Growth, Allocator>::deallocate(ElementType *someElements, unsigned int someCapacity) {
+   std::allocator_traits<Allocator>::deallocate(allocator, someElements, someCapacity);
+}
+
+// Description: Constructor, the array comes from anAllocator.
+template <class ElementType, class Compare, class Growth, class Allocator>
+BinaryHeap<ElementType, Compare, Growth, Allocator>::BinaryHeap(const Allocator &anAllocator) : allocator(anAllocator) {
+   elements = allocate(INITIAL_CAPACITY);
    elementCount = 0;
 }
 
 // Description: Destructor
-template <class ElementType>
-BinaryHeap<ElementType>::~BinaryHeap() {
-   delete[] elements;
+template <class ElementType, class Compare, class Growth, class Allocator>
+BinaryHeap<ElementType, Compare, Growth, Allocator>::~BinaryHeap() {
+   for (unsigned int i = 0; i < elementCount; i++)
+      elements[i].~ElementType();
+   deallocate(elements, capacity);
 }
 
 // Description: Copy Constructor
-template <class ElementType>
-BinaryHeap<ElementType>::BinaryHeap(const ElementType &newElement) {
-   capacity = newElement.capacity; //copy capacity
-   elementCount = newElement.elementCount; //copy element count
-
-   elements = new ElementType[capacity]; //allocate memory for elements array
-   for (unsigned int i = 0; i < capacity; i++) {
-      elements[i] = newElement[i]; //copy elements
+template <class ElementType, class Compare, class Growth, class Allocator>
+BinaryHeap<ElementType, Compare, Growth, Allocator>::BinaryHeap(const BinaryHeap &aHeap)
+   : allocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(aHeap.allocator)) {
+   capacity = aHeap.capacity; //copy capacity
+   elementCount = aHeap.elementCount; //copy element count
+   minimumCapacity = aHeap.minimumCapacity;
+
+   elements = allocate(capacity); //allocate memory for elements array
+   for (unsigned int i = 0; i < elementCount; i++) {
+      new (&elements[i]) ElementType(aHeap.elements[i]); //copy elements
    }
 }
 
 // Description: Overloaded Assignment Operator
-template <class ElementType>
-ElementType& BinaryHeap<ElementType>::operator=(const ElementType &newElement) {
-   if (this != &newElement) {
-      delete[] elements; //Deallocate existing memory
-
-      elements(newElement);
+template <class ElementType, class Compare, class Growth, class Allocator>
+BinaryHeap<ElementType, Compare, Growth, Allocator>& BinaryHeap<ElementType, Compare, Growth, Allocator>::operator=(const BinaryHeap &aHeap) {
+   if (this != &aHeap) {
+      BinaryHeap copy(aHeap); //Copy first, then release the existing memory with copy
+
+      std::swap(elements, copy.elements);
+      std::swap(allocator, copy.allocator);
+      std::swap(capacity, copy.capacity);
+      std::swap(elementCount, copy.elementCount);
+      std::swap(minimumCapacity, copy.minimumCapacity);
    }
    return *this;
 }
@@ -57,147 +85,230 @@ ElementType& BinaryHeap<ElementType>::operator=(const ElementType &newElement) {
 // Description: Returns the number of elements in the Binary Heap.
 // Postcondition: The Binary Heap is unchanged by this operation.
 // Time Efficiency: O(1)
-template <class ElementType>
-unsigned int BinaryHeap<ElementType>::getElementCount() const {
+template <class ElementType, class Compare, class Growth, class Allocator>
+unsigned int BinaryHeap<ElementType, Compare, Growth, Allocator>::getElementCount() const {
    return elementCount;
 }
 
 // Description: Inserts newElement into the Binary Heap.
 //              It returns true if successful, otherwise false.
 // Time Efficiency: O(log2 n)
-template <class ElementType>
-bool BinaryHeap<ElementType>::insert(ElementType &newElement) {
+template <class ElementType, class Compare, class Growth, class Allocator>
+bool BinaryHeap<ElementType, Compare, Growth, Allocator>::insert(const ElementType &newElement) {
+   ElementType copy(newElement);
+   return insert(std::move(copy));
+}
+
+// Description: Same as insert(), but moves newElement into the Binary Heap instead of copying it.
+// Time Efficiency: O(log2 n)
+template <class ElementType, class Compare, class Growth, class Allocator>
+bool BinaryHeap<ElementType, Compare, Growth, Allocator>::insert(ElementType &&newElement) {
    if (elementCount == capacity) { //If array is full resize it
-      resize(capacity*2);
+      resize(Growth::grow(capacity));
    }
 
-   //unsigned int indexOfRoot = 0;
-   unsigned int indexOfBottom = elementCount; //Index of new element
-
-   elements[indexOfBottom] = newElement; //Insert new element
+   // Open a hole at the bottom and move it up to where newElement belongs.
+   // The bottom cell is raw memory, so it is constructed from whatever settles in it first.
+   unsigned int indexOfBottom = elementCount;
    elementCount++; //Increment element count
-
-   if (elementCount > 1)
-      reHeapUp(indexOfBottom); //Restore heap order
+   BSIM_COUNT(HEAP_INSERTS);
+   unsigned int indexOfParent = (indexOfBottom - 1) / 2;
+   if (indexOfBottom > 0 && compare(newElement, elements[indexOfParent])) {
+      new (&elements[indexOfBottom]) ElementType(std::move(elements[indexOfParent]));
+      BSIM_COUNT(HEAP_SIFT_LEVELS);
+      reHeapUp(indexOfParent, newElement);
+   }
+   else
+      new (&elements[indexOfBottom]) ElementType(std::move(newElement));
 
    return true; 
 }
 
-// Description: Recursively put the array back into a Min Binary Heap.
-template <class ElementType>
-void BinaryHeap<ElementType>::reHeapUp(unsigned int indexOfBottom) {
+// Description: Constructs a new element from arguments and inserts it into the Binary Heap.
+//              It returns true if successful, otherwise false.
+// Time Efficiency: O(log2 n)
+template <class ElementType, class Compare, class Growth, class Allocator>
+template <class... Arguments>
+bool BinaryHeap<ElementType, Compare, Growth, Allocator>::emplace(Arguments &&... arguments) {
+   return insert(ElementType(std::forward<Arguments>(arguments)...));
+}
+
+// Description: Put the array back into a Min Binary Heap by moving the hole
+//              at indexOfBottom up until element fits in it.
+//              Each level costs one comparison and one move, no swaps.
+template <class ElementType, class Compare, class Growth, class Allocator>
+void BinaryHeap<ElementType, Compare, Growth, Allocator>::reHeapUp(unsigned int indexOfBottom, ElementType &element) {
 
-   if (indexOfBottom > 0) {
-      unsigned int indexOfParent = floor((indexOfBottom-1)/2); //Calculate parent Index
+   while (indexOfBottom > 0) {
+      unsigned int indexOfParent = (indexOfBottom - 1) / 2; //Calculate parent Index
 
-      if (elements[indexOfBottom] <= elements[indexOfParent]) {
-         // Swap the parent and the current element
-         ElementType temp = elements[indexOfBottom];
-         elements[indexOfBottom] = elements[indexOfParent];
-         elements[indexOfParent] = temp;
+      if (!compare(element, elements[indexOfParent]))
+         break;
 
-         // Recursively put array back in heap
-         reHeapUp(indexOfParent);
-      }
+      // Move the parent down into the hole
+      elements[indexOfBottom] = std::move(elements[indexOfParent]);
+      indexOfBottom = indexOfParent;
+      BSIM_COUNT(HEAP_SIFT_LEVELS);
    }
+   elements[indexOfBottom] = std::move(element);
    return;
 }
 
 
+// Description: Retrieves (but does not remove) the necessary element,
+//              without checking that there is one.
+template <class ElementType, class Compare, class Growth, class Allocator>
+ElementType & BinaryHeap<ElementType, Compare, Growth, Allocator>::retrieveUnchecked() const {
+   return elements[0]; // Return root elements
+}
+
 // Description: Retrieves (but does not remove) the necessary element.
 // Precondition: This Binary Heap is not empty.
 // Postcondition: This Binary Heap is unchanged.
 // Exceptions: Throws EmptyDataCollectionException if this Binary Heap is empty.
 // Time Efficiency: O(1)
-template <class ElementType>
-ElementType & BinaryHeap<ElementType>::retrieve() const {
+template <class ElementType, class Compare, class Growth, class Allocator>
+ElementType & BinaryHeap<ElementType, Compare, Growth, Allocator>::retrieve() const {
    if (elementCount == 0)
       throw EmptyDataCollectionException("retrieve() callec with an empty BinaryHeap");
-
-   return elements[0]; // Return root elements
+   return retrieveUnchecked();
 }
 
-// Description: Removes (but does not return) the necessary element.
+// Description: Removes the necessary element and returns it, moved out rather than copied.
 // Precondition: This Binary Heap is not empty.
 // Exceptions: Throws EmptyDataCollectionException if this Binary Heap is empty.
 // Time Efficiency: O(log2 n)
-template <class ElementType>
-void BinaryHeap<ElementType>::remove() {  
-
-   if(elementCount == 0) 
-      throw EmptyDataCollectionException("remove() called with an empty BinaryHeap.");
+template <class ElementType, class Compare, class Growth, class Allocator>
+ElementType BinaryHeap<ElementType, Compare, Growth, Allocator>::pop() {
+   if (elementCount == 0)
+      throw EmptyDataCollectionException("pop() called with an empty BinaryHeap.");
+   ElementType root(std::move(elements[0]));
+   removeUnchecked();
+   return root;
+}
 
-   elements[0] = elements[elementCount - 1]; //Replace root with last element
+// Description: Removes (but does not return) the necessary element,
+//              without checking that there is one.
+template <class ElementType, class Compare, class Growth, class Allocator>
+void BinaryHeap<ElementType, Compare, Growth, Allocator>::removeUnchecked() {  
    elementCount--; //decrement element count
-   
+   BSIM_COUNT(HEAP_REMOVES);
+
+   // Replace root with last element: move the hole left at the root down to where it belongs
+   ElementType last = std::move(elements[elementCount]);
+   elements[elementCount].~ElementType();
+
    // No need to call reheapDown() is we have just removed the only element
-   if ( elementCount > 0 ) 
-      reHeapDown(0); //Restore heap order
+   if ( elementCount > 0 ) {
+      reHeapDown(0, last); //Restore heap order
+   }
 
-   if (elementCount < (capacity/4) && ((capacity/2) >= INITIAL_CAPACITY)) {
-      resize(capacity/2); //Shrink array if necessary
+   unsigned int newCapacity = Growth::shrink(capacity, elementCount, minimumCapacity);
+   if (newCapacity != capacity) {
+      resize(newCapacity); //Shrink array if necessary
    } 
    
    return;   
 }
 
+// Description: Removes (but does not return) the necessary element.
+// Precondition: This Binary Heap is not empty.
+// Exceptions: Throws EmptyDataCollectionException if this Binary Heap is empty.
+// Time Efficiency: O(log2 n)
+template <class ElementType, class Compare, class Growth, class Allocator>
+void BinaryHeap<ElementType, Compare, Growth, Allocator>::remove() {  
+   if(elementCount == 0) 
+      throw EmptyDataCollectionException("remove() called with an empty BinaryHeap.");
+   removeUnchecked();
+}
+
 // Utility method
-// Description: Recursively put the array back into a Min Binary Heap.
-template <class ElementType>
-void BinaryHeap<ElementType>::reHeapDown(unsigned int indexOfRoot) {
+// Description: Put the array back into a Min Binary Heap by moving the hole
+//              at indexOfRoot down until element fits in it.
+//              Each level moves the smallest child up into the hole, no swaps.
+template <class ElementType, class Compare, class Growth, class Allocator>
+void BinaryHeap<ElementType, Compare, Growth, Allocator>::reHeapDown(unsigned int indexOfRoot, ElementType &element) {
+
+   while (true) {
+      // Find indices of children.
+      unsigned int indexOfLeftChild = 2 * indexOfRoot + 1;
+      unsigned int indexOfRightChild = indexOfLeftChild + 1;
+
+      // elements[indexOfRoot] is a leaf as it has no children
+      if (indexOfLeftChild >= elementCount) break;
+
+      // Select the smallest of element and the children
+      // If (element > elements[indexOfLeftChild])
+      const ElementType *minElement = &element;
+      unsigned int indexOfMinChild = indexOfRoot;
+      if ( ! compare(element, elements[indexOfLeftChild]) ) {
+         minElement = &elements[indexOfLeftChild];
+         indexOfMinChild = indexOfLeftChild;
+      }
 
-   unsigned int indexOfMinChild = indexOfRoot;
-   
-   // Find indices of children.
-   unsigned int indexOfLeftChild = 2 * indexOfRoot + 1;
-   unsigned int indexOfRightChild = 2 * indexOfRoot + 2;
-
-   // Base case: elements[indexOfRoot] is a leaf as it has no children
-   if (indexOfLeftChild > elementCount - 1) return;
-
-   // If we need to swap, select the smallest child
-   // If (elements[indexOfRoot] > elements[indexOfLeftChild])
-   if ( ! (elements[indexOfRoot] <= elements[indexOfLeftChild]) )
-      indexOfMinChild = indexOfLeftChild;
-
-   // Check if there is a right child, is it the smallest?
-   if (indexOfRightChild < elementCount) {
-      // if (elements[indexOfMinChild] > elements[indexOfRightChild])
-      if ( ! (elements[indexOfMinChild] <= elements[indexOfRightChild]) )
+      // Check if there is a right child, is it the smallest?
+      if (indexOfRightChild < elementCount && ! compare(*minElement, elements[indexOfRightChild]) )
          indexOfMinChild = indexOfRightChild;
-   }
 
-   // Swap parent with smallest of children.
-   if (indexOfMinChild != indexOfRoot) {
-      
-      ElementType temp = elements[indexOfRoot];
-      elements[indexOfRoot] = elements[indexOfMinChild];
-      elements[indexOfMinChild] = temp;
-      
-      // Recursively put the array back into a heap
-      reHeapDown(indexOfMinChild);
+      if (indexOfMinChild == indexOfRoot) break;
+
+      // Move the smallest child up into the hole
+      elements[indexOfRoot] = std::move(elements[indexOfMinChild]);
+      indexOfRoot = indexOfMinChild;
+      BSIM_COUNT(HEAP_SIFT_LEVELS);
    }
+   elements[indexOfRoot] = std::move(element);
    return;
 } 
 
 
 // Description: Resize the array
-template <class ElementType>
-void BinaryHeap<ElementType>::resize(unsigned int newCapacity) {
-   ElementType * newElements = new ElementType[newCapacity];
+//              The elements are moved (not copied) into the new array.
+template <class ElementType, class Compare, class Growth, class Allocator>
+void BinaryHeap<ElementType, Compare, Growth, Allocator>::resize(unsigned int newCapacity) {
+   ElementType * newElements = allocate(newCapacity);
    for (unsigned int i = 0; i < elementCount; i++) {
-      newElements[i] = elements[i];
+      new (&newElements[i]) ElementType(std::move(elements[i]));
+      elements[i].~ElementType();
    }
 
-   delete[] elements;
+   deallocate(elements, capacity);
    elements = newElements;
    capacity = newCapacity;
+   reallocationCount++;
+   BSIM_COUNT(HEAP_RESIZES);
+}
+
+// Description: Makes room for at least newCapacity elements, so the Binary Heap
+//              can grow to that many without reallocating, and keeps at least
+//              that much room from then on.
+// Time Efficiency: O(n) if the array is reallocated, otherwise O(1)
+template <class ElementType, class Compare, class Growth, class Allocator>
+void BinaryHeap<ElementType, Compare, Growth, Allocator>::reserve(unsigned int newCapacity) {
+   if (newCapacity > minimumCapacity)
+      minimumCapacity = newCapacity;
+   if (newCapacity > capacity)
+      resize(newCapacity);
+}
+
+// Description: Returns the number of elements the Binary Heap holds without reallocating.
+// Time Efficiency: O(1)
+template <class ElementType, class Compare, class Growth, class Allocator>
+unsigned int BinaryHeap<ElementType, Compare, Growth, Allocator>::getCapacity() const {
+   return capacity;
+}
+
+// Description: Returns the number of times the array was reallocated (grown or shrunk).
+// Time Efficiency: O(1)
+template <class ElementType, class Compare, class Growth, class Allocator>
+unsigned long long BinaryHeap<ElementType, Compare, Growth, Allocator>::getReallocationCount() const {
+   return reallocationCount;
 }
 
 
 // For testing purposes
-template <class ElementType>
-void BinaryHeap<ElementType>::print() {
+template <class ElementType, class Compare, class Growth, class Allocator>
+void BinaryHeap<ElementType, Compare, Growth, Allocator>::print() {
    if (elementCount == 0)
       throw EmptyDataCollectionException("print() was called with an empty Heap.");
 
@@ -2,8 +2,14 @@
  * BinaryHeap.h
  * 
  * Description: Min Binary Heap ADT class.
+ *              Compare(a, b) is true when a may come out of the heap before b
+ *              (HeapOrder<ElementType>, i.e. a <= b, by default).
+ *              Growth decides when the array is reallocated (see GrowthPolicy.h)
+ *              and Allocator where its memory comes from (e.g. ArenaAllocator).
  *
  * Class Invariant:  Always a Min Binary Heap.
+ *                   elements[0 .. elementCount-1] are constructed, the
+ *                   rest of the array is raw memory.
  * 
  * Author: Vansh Thakur Rana (vtr)
  *         Agrim Joshi (aja121)
@@ -13,45 +19,57 @@
 #ifndef BinaryHeap_H
 #define BinaryHeap_H
 
+#include <memory>
 #include"Event.h"
 #include "Queue.h"
+#include "HeapOrder.h"
+#include "GrowthPolicy.h"
 #include "EmptyDataCollectionException.h"
 
 
 
-template <class ElementType>
+template <class ElementType, class Compare = HeapOrder<ElementType>, class Growth = DefaultGrowth,
+          class Allocator = std::allocator<ElementType>>
 class BinaryHeap {
 
     private:
 
         ElementType *elements;
+        Allocator allocator;                      // Where the array comes from
 
         static unsigned int const INITIAL_CAPACITY = 6; // Constant INITIAL_CAPACITY
         unsigned int elementCount = 0;            // Number of elements in the Binary Heap
         unsigned int capacity = INITIAL_CAPACITY; // Actual capacity of the data structure (number of cells in the array)
+        unsigned int minimumCapacity = INITIAL_CAPACITY; // The array never shrinks below this (see reserve())
+        unsigned long long reallocationCount = 0; // Number of times the array was reallocated
+        Compare compare;                          // Heap order
 
         // Utility method
-        // Description: Recursively put the array back into a Min Binary Heap.
-        void reHeapDown(unsigned int indexOfRoot);
+        // Description: Put the array back into a Min Binary Heap by moving the hole
+        //              at indexOfRoot down until element fits in it, then move element there.
+        void reHeapDown(unsigned int indexOfRoot, ElementType &element);
 
-        // Description: 
-        void reHeapUp(unsigned int indexOfBottom);
+        // Description: Put the array back into a Min Binary Heap by moving the hole
+        //              at indexOfBottom up until element fits in it, then move element there.
+        void reHeapUp(unsigned int indexOfBottom, ElementType &element);
 
+        ElementType *allocate(unsigned int newCapacity); // Raw memory for newCapacity elements
+        void deallocate(ElementType *someElements, unsigned int someCapacity); // Gives the memory back
         void resize(unsigned int newCapacity); // To resize the array
 
     public:
 
-        // Description: Constructor
-        BinaryHeap();
+        // Description: Constructor, the array comes from anAllocator.
+        explicit BinaryHeap(const Allocator &anAllocator = Allocator());
 
         // Description: Destructor
         ~BinaryHeap();
 
         // Description: Copy Constructor
-        BinaryHeap(const ElementType &newElement);
+        BinaryHeap(const BinaryHeap &aHeap);
 
         // Description: Overloaded Assignment Operator
-        ElementType & operator=(const ElementType &newElement);
+        BinaryHeap & operator=(const BinaryHeap &aHeap);
 
         // Description: Returns the number of elements in the Binary Heap.
         // Postcondition: The Binary Heap is unchanged by this operation.
@@ -61,7 +79,17 @@ class BinaryHeap {
         // Description: Inserts newElement into the Binary Heap.
         //              It returns true if successful, otherwise false.
         // Time Efficiency: O(log2 n)
-        bool insert(ElementType &newElement);
+        bool insert(const ElementType &newElement);
+
+        // Description: Same as insert(), but moves newElement into the Binary Heap instead of copying it.
+        // Time Efficiency: O(log2 n)
+        bool insert(ElementType &&newElement);
+
+        // Description: Constructs a new element from arguments and inserts it into the Binary Heap.
+        //              It returns true if successful, otherwise false.
+        // Time Efficiency: O(log2 n)
+        template <class... Arguments>
+        bool emplace(Arguments &&... arguments);
 
         // Description: Removes (but does not return) the necessary element.
         // Precondition: This Binary Heap is not empty.
@@ -76,6 +104,33 @@ class BinaryHeap {
         // Time Efficiency: O(1)
         ElementType &retrieve() const;
 
+        // Description: Removes the necessary element and returns it, moved out rather than copied.
+        // Precondition: This Binary Heap is not empty.
+        // Exceptions: Throws EmptyDataCollectionException if this Binary Heap is empty.
+        // Time Efficiency: O(log2 n)
+        ElementType pop();
+
+        // Description: Same as remove() and retrieve(), but without checking that the Binary Heap
+        //              is not empty, for callers that have already checked it (the event loop).
+        // Precondition: This Binary Heap is not empty. Otherwise the behaviour is undefined.
+        // Time Efficiency: O(log2 n), and O(1)
+        void removeUnchecked();
+        ElementType &retrieveUnchecked() const;
+
+        // Description: Makes room for at least newCapacity elements, so the Binary Heap
+        //              can grow to that many without reallocating, and keeps at least
+        //              that much room from then on.
+        // Time Efficiency: O(n) if the array is reallocated, otherwise O(1)
+        void reserve(unsigned int newCapacity);
+
+        // Description: Returns the number of elements the Binary Heap holds without reallocating.
+        // Time Efficiency: O(1)
+        unsigned int getCapacity() const;
+
+        // Description: Returns the number of times the array was reallocated (grown or shrunk).
+        // Time Efficiency: O(1)
+        unsigned long long getReallocationCount() const;
+
 
         // For testing purposes
         void print();
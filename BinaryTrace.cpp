@@ -0,0 +1,155 @@
+/*
+ * BinaryTrace.cpp
+ *
+ * Description: Compact fixed-width binary trace format for arrival events,
+ *              a writer to produce it and a memory-mapped reader for it.
+ *
+ * Class Invariant: Records are stored in the order they were written.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "BinaryTrace.h"
+
+using std::string;
+using std::runtime_error;
+
+
+// Description: Constructor, creates fileName and writes a provisional header.
+BinaryTraceWriter::BinaryTraceWriter(const string &fileName, uint32_t someFields) : fields(someFields) {
+    file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr)
+        throw runtime_error("could not create binary trace " + fileName);
+
+    BinaryTrace::Header header;
+    memcpy(header.magic, BinaryTrace::MAGIC, sizeof(header.magic));
+    header.version = BinaryTrace::VERSION;
+    header.fields = fields;
+    header.recordCount = 0;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        throw runtime_error("could not write binary trace " + fileName);
+    }
+}
+
+// Description: Destructor, finishes the file if close() was not called.
+BinaryTraceWriter::~BinaryTraceWriter() {
+    if (file != nullptr) {
+        try {
+            close();
+        } catch (runtime_error &) { }
+    }
+}
+
+// Description: Appends one arrival to the trace.
+// Exceptions: Throws runtime_error if the file cannot be written.
+void BinaryTraceWriter::write(const BinaryTrace::Record &record) {
+    if (fwrite(&record, BinaryTrace::recordSize(fields), 1, file) != 1)
+        throw runtime_error("could not write binary trace");
+    recordCount++;
+}
+
+// Description: Appends one arrival event to the trace.
+void BinaryTraceWriter::write(const Event &arrivalEvent) {
+    BinaryTrace::Record record = { arrivalEvent.getTime(), arrivalEvent.getLength(), 0, 0 };
+    write(record);
+}
+
+// Description: Writes the final record count into the header and closes the file.
+void BinaryTraceWriter::close() {
+    bool written = fseek(file, offsetof(BinaryTrace::Header, recordCount), SEEK_SET) == 0
+                   && fwrite(&recordCount, sizeof(recordCount), 1, file) == 1;
+    written = (fclose(file) == 0) && written;
+    file = nullptr;
+
+    if (!written)
+        throw runtime_error("could not write binary trace");
+}
+
+
+// Description: Constructor, maps fileName and checks its header.
+MappedTraceReader::MappedTraceReader(const string &fileName) {
+    int descriptor = open(fileName.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        throw runtime_error("could not open binary trace " + fileName);
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || (size_t)status.st_size < sizeof(BinaryTrace::Header)) {
+        ::close(descriptor);
+        throw runtime_error(fileName + " is not a binary trace");
+    }
+
+    mappingSize = status.st_size;
+    void *address = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (address == MAP_FAILED)
+        throw runtime_error("could not map binary trace " + fileName);
+    mapping = (const char *)address;
+    madvise(address, mappingSize, MADV_SEQUENTIAL);
+
+    BinaryTrace::Header header;
+    memcpy(&header, mapping, sizeof(header));
+    fields = header.fields;
+    stride = BinaryTrace::recordSize(fields);
+    records = mapping + sizeof(header);
+    recordCount = header.recordCount;
+
+    if (memcmp(header.magic, BinaryTrace::MAGIC, sizeof(header.magic)) != 0
+        || header.version != BinaryTrace::VERSION
+        || recordCount > (mappingSize - sizeof(header)) / stride) {
+        munmap(address, mappingSize);
+        throw runtime_error(fileName + " is not a binary trace");
+    }
+}
+
+// Description: Destructor, unmaps the file.
+MappedTraceReader::~MappedTraceReader() {
+    munmap((void *)mapping, mappingSize);
+}
+
+// Description: Returns the number of arrivals in the trace.
+uint64_t MappedTraceReader::getRecordCount() const {
+    return recordCount;
+}
+
+// Description: Returns true if the records carry teller and customer class.
+bool MappedTraceReader::hasTellerClass() const {
+    return (fields & BinaryTrace::FIELD_TELLER_CLASS) != 0;
+}
+
+// Description: Returns the time of record i, straight from the mapping.
+int32_t MappedTraceReader::timeAt(uint64_t i) const {
+    int32_t time;
+    memcpy(&time, records + i * stride, sizeof(time));
+    return time;
+}
+
+// Description: Returns the length of record i, straight from the mapping.
+int32_t MappedTraceReader::lengthAt(uint64_t i) const {
+    int32_t length;
+    memcpy(&length, records + i * stride + sizeof(int32_t), sizeof(length));
+    return length;
+}
+
+// Description: Reads the next arrival into newEvent.
+bool MappedTraceReader::next(Event &newEvent) {
+    if (nextRecord == recordCount)
+        return false;
+
+    newEvent = Event(Event::ARRIVAL, timeAt(nextRecord), lengthAt(nextRecord));
+    nextRecord++;
+    return true;
+}
+
+// Description: Skips the next count arrivals.
+unsigned long long MappedTraceReader::skip(unsigned long long count) {
+    if (count > recordCount - nextRecord)
+        count = recordCount - nextRecord;
+    nextRecord += count;
+    return count;
+}
@@ -0,0 +1,122 @@
+/*
+ * BinaryTrace.h
+ *
+ * Description: Compact fixed-width binary trace format for arrival events,
+ *              a writer to produce it and a memory-mapped reader for it.
+ *
+ *              Layout (native byte order):
+ *                  header : magic "BSIMTRC1", uint32 version, uint32 fields,
+ *                           uint64 record count
+ *                  records: int32 time, int32 length
+ *                           [, int32 teller, int32 customer class]  (FIELD_TELLER_CLASS)
+ *
+ * Class Invariant: Records are stored in the order they were written.
+ */
+
+#ifndef BINARY_TRACE_H
+#define BINARY_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "Event.h"
+#include "ArrivalReader.h"
+
+namespace BinaryTrace {
+    static char const MAGIC[8] = { 'B', 'S', 'I', 'M', 'T', 'R', 'C', '1' };
+    static uint32_t const VERSION = 1;
+    static uint32_t const FIELD_TELLER_CLASS = 1;   // Records carry teller and customer class
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t fields;
+        uint64_t recordCount;
+    };
+
+    // One arrival. Only the first recordSize(fields) bytes are stored.
+    struct Record {
+        int32_t time;
+        int32_t length;
+        int32_t teller;
+        int32_t customerClass;
+    };
+
+    // Description: Returns the size in bytes of one record with the given fields.
+    inline unsigned int recordSize(uint32_t fields) {
+        return (fields & FIELD_TELLER_CLASS) ? sizeof(Record) : 2 * sizeof(int32_t);
+    }
+}
+
+
+// Writes arrivals to a binary trace file.
+class BinaryTraceWriter {
+
+    private:
+        FILE *file;
+        uint32_t fields;
+        uint64_t recordCount = 0;
+
+    public:
+        // Description: Constructor, creates fileName and writes a provisional header.
+        // Exceptions: Throws runtime_error if the file cannot be created.
+        BinaryTraceWriter(const std::string &fileName, uint32_t someFields = 0);
+
+        // Description: Destructor, finishes the file if close() was not called.
+        ~BinaryTraceWriter();
+
+        // Description: Appends one arrival to the trace.
+        // Exceptions: Throws runtime_error if the file cannot be written.
+        void write(const BinaryTrace::Record &record);
+
+        // Description: Appends one arrival event to the trace.
+        void write(const Event &arrivalEvent);
+
+        // Description: Writes the final record count into the header and closes the file.
+        // Exceptions: Throws runtime_error if the file cannot be written.
+        void close();
+};
+
+
+// Maps a binary trace file into memory and hands its arrivals out without copying the file.
+class MappedTraceReader : public ArrivalReader {
+
+    private:
+        const char *mapping = nullptr;   // Whole file, mapped read-only
+        size_t mappingSize = 0;
+        const char *records = nullptr;   // First record
+        unsigned int stride = 0;         // Size of one record
+        uint64_t recordCount = 0;
+        uint64_t nextRecord = 0;         // Next record next() hands out
+        uint32_t fields = 0;
+
+    public:
+        // Description: Constructor, maps fileName and checks its header.
+        // Exceptions: Throws runtime_error if the file is missing or not a valid trace.
+        MappedTraceReader(const std::string &fileName);
+
+        // Description: Destructor, unmaps the file.
+        ~MappedTraceReader();
+
+        // Description: Returns the number of arrivals in the trace.
+        uint64_t getRecordCount() const;
+
+        // Description: Returns true if the records carry teller and customer class.
+        bool hasTellerClass() const;
+
+        // Description: Returns the time of record i, straight from the mapping.
+        // Precondition: i < getRecordCount()
+        int32_t timeAt(uint64_t i) const;
+
+        // Description: Returns the length of record i, straight from the mapping.
+        // Precondition: i < getRecordCount()
+        int32_t lengthAt(uint64_t i) const;
+
+        // Description: Reads the next arrival into newEvent.
+        bool next(Event &newEvent);
+
+        // Description: Skips the next count arrivals.
+        // Time Efficiency: O(1)
+        unsigned long long skip(unsigned long long count);
+};
+#endif
@@ -0,0 +1,181 @@
+/*
+ * CalendarQueue.cpp
+ *
+ * Description: Calendar queue (R. Brown, 1988), a bucketed alternative to the
+ *              heaps for elements with integer times, with the same interface
+ *              as BinaryHeap so it can back a PriorityQueue.
+ *              Time is divided into days of bucketWidth time units and a year of
+ *              numberOfBuckets days; an element goes into the bucket of its day
+ *              modulo the year. Each bucket is kept sorted by Compare, so equal
+ *              times keep the heap tie-breaking (arrivals before departures).
+ *              Scanning forward from the current day finds the next element in
+ *              amortized O(1) when the width matches the spacing of the times,
+ *              which the queue re-estimates whenever it doubles or halves.
+ *
+ * Class Invariant: Every element is in bucket (time / bucketWidth) mod numberOfBuckets,
+ *                  each bucket sorted with its first element (by Compare) last.
+ *                  No element is earlier than the current day.
+ *                  ElementType provides int getTime() const.
+ */
+
+#include <algorithm>
+#include <utility>
+#include "CalendarQueue.h"  // Header file
+
+
+// Description: Constructor
+template <class ElementType, class Compare>
+CalendarQueue<ElementType, Compare>::CalendarQueue() {
+    buckets = new std::vector<ElementType>[numberOfBuckets];
+}
+
+// Description: Destructor
+template <class ElementType, class Compare>
+CalendarQueue<ElementType, Compare>::~CalendarQueue() {
+    delete[] buckets;
+}
+
+// Description: Returns the number of elements in the Calendar Queue.
+template <class ElementType, class Compare>
+unsigned int CalendarQueue<ElementType, Compare>::getElementCount() const {
+    return elementCount;
+}
+
+// Description: Returns the day (time / bucketWidth, rounded down) of time.
+template <class ElementType, class Compare>
+long long CalendarQueue<ElementType, Compare>::dayOf(int time) const {
+    return (long long)time >> widthShift;
+}
+
+// Description: Puts newElement in its bucket, keeping the bucket sorted.
+//              Elements equal to newElement stay closer to the back, so they come out first.
+template <class ElementType, class Compare>
+void CalendarQueue<ElementType, Compare>::place(const ElementType &newElement) {
+    std::vector<ElementType> &bucket = buckets[dayOf(newElement.getTime()) & (numberOfBuckets - 1)];
+    auto position = std::partition_point(bucket.begin(), bucket.end(), [&](const ElementType &element) {
+        return !compare(element, newElement);
+    });
+    bucket.insert(position, newElement);
+}
+
+// Description: Inserts newElement into the Calendar Queue.
+template <class ElementType, class Compare>
+bool CalendarQueue<ElementType, Compare>::insert(const ElementType &newElement) {
+    long long day = dayOf(newElement.getTime());
+    if (elementCount == 0 || day < (dayEnd >> widthShift) - 1) {
+        // Earlier than the current day: it becomes the current day
+        currentBucket = day & (numberOfBuckets - 1);
+        dayEnd = (day + 1) * (1LL << widthShift);
+    }
+
+    place(newElement);
+    elementCount++;
+
+    if (elementCount > 2 * numberOfBuckets)
+        resize(2 * numberOfBuckets);
+    return true;
+}
+
+// Description: Moves the current day forward to the day of the first element.
+template <class ElementType, class Compare>
+void CalendarQueue<ElementType, Compare>::locate() const {
+    // Scan one year of days for an element due on its day
+    for (unsigned int day = 0; day < numberOfBuckets; day++) {
+        const std::vector<ElementType> &bucket = buckets[currentBucket];
+        if (!bucket.empty() && bucket.back().getTime() < dayEnd)
+            return;
+        currentBucket = (currentBucket + 1) & (numberOfBuckets - 1);
+        dayEnd += 1LL << widthShift;
+    }
+
+    // Nothing due within a year: jump straight to the earliest element
+    const ElementType *first = nullptr;
+    for (unsigned int i = 0; i < numberOfBuckets; i++)
+        if (!buckets[i].empty() && (first == nullptr || !compare(*first, buckets[i].back())))
+            first = &buckets[i].back();
+
+    long long day = dayOf(first->getTime());
+    currentBucket = day & (numberOfBuckets - 1);
+    dayEnd = (day + 1) * (1LL << widthShift);
+}
+
+// Description: Retrieves (but does not remove) the necessary element,
+//              without checking that there is one.
+template <class ElementType, class Compare>
+ElementType & CalendarQueue<ElementType, Compare>::retrieveUnchecked() const {
+    locate();
+    return buckets[currentBucket].back();
+}
+
+// Description: Retrieves (but does not remove) the necessary element.
+template <class ElementType, class Compare>
+ElementType & CalendarQueue<ElementType, Compare>::retrieve() const {
+    if (elementCount == 0)
+        throw EmptyDataCollectionException("retrieve() called with an empty CalendarQueue.");
+    return retrieveUnchecked();
+}
+
+// Description: Removes (but does not return) the necessary element,
+//              without checking that there is one.
+template <class ElementType, class Compare>
+void CalendarQueue<ElementType, Compare>::removeUnchecked() {
+    locate();
+    buckets[currentBucket].pop_back();
+    elementCount--;
+
+    if (elementCount < numberOfBuckets / 2 && numberOfBuckets > MINIMUM_BUCKETS)
+        resize(numberOfBuckets / 2);
+}
+
+// Description: Removes (but does not return) the necessary element.
+template <class ElementType, class Compare>
+void CalendarQueue<ElementType, Compare>::remove() {
+    if (elementCount == 0)
+        throw EmptyDataCollectionException("remove() called with an empty CalendarQueue.");
+    removeUnchecked();
+}
+
+// Description: Rebuilds the calendar with newNumberOfBuckets buckets and a
+//              bucket width estimated from the spacing of the earliest elements:
+//              about three elements per day on average.
+template <class ElementType, class Compare>
+void CalendarQueue<ElementType, Compare>::resize(unsigned int newNumberOfBuckets) {
+    std::vector<ElementType> all;
+    all.reserve(elementCount);
+    for (unsigned int i = 0; i < numberOfBuckets; i++)
+        for (unsigned int j = 0; j < buckets[i].size(); j++)
+            all.push_back(std::move(buckets[i][j]));
+
+    delete[] buckets;
+    numberOfBuckets = newNumberOfBuckets;
+    buckets = new std::vector<ElementType>[numberOfBuckets];
+    reallocationCount++;
+
+    widthShift = 0;
+    if (!all.empty()) {
+        std::vector<int> times(all.size());
+        for (unsigned int i = 0; i < all.size(); i++)
+            times[i] = all[i].getTime();
+
+        unsigned int sample = (times.size() < WIDTH_SAMPLE) ? (unsigned int)times.size() : WIDTH_SAMPLE;
+        std::nth_element(times.begin(), times.begin() + (sample - 1), times.end());
+        int earliest = *std::min_element(times.begin(), times.begin() + sample);
+        long long spacing = (sample > 1) ? ((long long)times[sample - 1] - earliest) / (sample - 1) : 1;
+        while (widthShift < 31 && (1LL << widthShift) < 3 * spacing)
+            widthShift++;
+
+        // The earliest element's day becomes the current day
+        long long day = dayOf(earliest);
+        currentBucket = day & (numberOfBuckets - 1);
+        dayEnd = (day + 1) * (1LL << widthShift);
+    }
+
+    for (unsigned int i = 0; i < all.size(); i++)
+        place(all[i]);
+}
+
+// Description: Returns the number of times the calendar was rebuilt (grown or shrunk).
+template <class ElementType, class Compare>
+unsigned long long CalendarQueue<ElementType, Compare>::getReallocationCount() const {
+    return reallocationCount;
+}
@@ -0,0 +1,104 @@
+/*
+ * CalendarQueue.h
+ *
+ * Description: Calendar queue (R. Brown, 1988), a bucketed alternative to the
+ *              heaps for elements with integer times, with the same interface
+ *              as BinaryHeap so it can back a PriorityQueue.
+ *              Time is divided into days of bucketWidth time units and a year of
+ *              numberOfBuckets days; an element goes into the bucket of its day
+ *              modulo the year. Each bucket is kept sorted by Compare, so equal
+ *              times keep the heap tie-breaking (arrivals before departures).
+ *              Scanning forward from the current day finds the next element in
+ *              amortized O(1) when the width matches the spacing of the times,
+ *              which the queue re-estimates whenever it doubles or halves.
+ *
+ * Class Invariant: Every element is in bucket (time / bucketWidth) mod numberOfBuckets,
+ *                  each bucket sorted with its first element (by Compare) last.
+ *                  No element is earlier than the current day.
+ *                  ElementType provides int getTime() const.
+ */
+
+#ifndef CALENDAR_QUEUE_H
+#define CALENDAR_QUEUE_H
+
+#include <vector>
+#include "HeapOrder.h"
+#include "EmptyDataCollectionException.h"
+
+
+template <class ElementType, class Compare = HeapOrder<ElementType>>
+class CalendarQueue {
+
+    private:
+        static unsigned int const MINIMUM_BUCKETS = 2;
+        static unsigned int const WIDTH_SAMPLE = 32;   // Earliest elements used to estimate the bucket width
+
+        std::vector<ElementType> *buckets;
+        unsigned int numberOfBuckets = MINIMUM_BUCKETS;   // Power of 2
+        unsigned int widthShift = 0;                      // bucketWidth == 1 << widthShift
+        unsigned int elementCount = 0;
+        unsigned long long reallocationCount = 0;         // Number of times the calendar was rebuilt
+        Compare compare;                                  // Order within a bucket
+
+        // Current day: retrieve() looks there first. Moved forward by locate().
+        mutable unsigned int currentBucket = 0;
+        mutable long long dayEnd = 1;                     // First time after the current day
+
+        // Description: Returns the day (time / bucketWidth, rounded down) of time.
+        long long dayOf(int time) const;
+
+        // Description: Moves the current day forward to the day of the first element.
+        // Precondition: This Calendar Queue is not empty.
+        void locate() const;
+
+        // Description: Puts newElement in its bucket, keeping the bucket sorted.
+        void place(const ElementType &newElement);
+
+        // Description: Rebuilds the calendar with newNumberOfBuckets buckets and a
+        //              bucket width estimated from the spacing of the earliest elements.
+        void resize(unsigned int newNumberOfBuckets);
+
+    public:
+        // Description: Constructor
+        CalendarQueue();
+
+        // Description: Destructor
+        ~CalendarQueue();
+
+        CalendarQueue(const CalendarQueue &) = delete;
+        CalendarQueue & operator=(const CalendarQueue &) = delete;
+
+        // Description: Returns the number of elements in the Calendar Queue.
+        // Time Efficiency: O(1)
+        unsigned int getElementCount() const;
+
+        // Description: Inserts newElement into the Calendar Queue.
+        //              It returns true if successful, otherwise false.
+        // Time Efficiency: O(1) amortized
+        bool insert(const ElementType &newElement);
+
+        // Description: Removes (but does not return) the necessary element.
+        // Precondition: This Calendar Queue is not empty.
+        // Exceptions: Throws EmptyDataCollectionException if this Calendar Queue is empty.
+        // Time Efficiency: O(1) amortized
+        void remove();
+
+        // Description: Retrieves (but does not remove) the necessary element.
+        // Precondition: This Calendar Queue is not empty.
+        // Exceptions: Throws EmptyDataCollectionException if this Calendar Queue is empty.
+        // Time Efficiency: O(1) amortized
+        ElementType &retrieve() const;
+
+        // Description: Same as remove() and retrieve(), but without checking that the Calendar Queue
+        //              is not empty, for callers that have already checked it (the event loop).
+        // Precondition: This Calendar Queue is not empty. Otherwise the behaviour is undefined.
+        // Time Efficiency: O(1) amortized, and O(1)
+        void removeUnchecked();
+        ElementType &retrieveUnchecked() const;
+
+        // Description: Returns the number of times the calendar was rebuilt (grown or shrunk).
+        // Time Efficiency: O(1)
+        unsigned long long getReallocationCount() const;
+};
+#include "CalendarQueue.cpp"
+#endif
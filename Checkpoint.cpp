@@ -0,0 +1,324 @@
+/*
+ * Checkpoint.cpp
+ *
+ * Description: Compact binary checkpoints of a simulation run in progress:
+ *              the writer, the reader and Checkpointer (see Checkpoint.h).
+ *
+ * Class Invariant: A reader hands the values back in the order the writer put them.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Checkpoint.h"
+#include "Simulation.h"
+
+using std::string;
+using std::runtime_error;
+
+
+// Description: Constructor, starts with the header.
+CheckpointWriter::CheckpointWriter() {
+    put(Checkpoint::MAGIC, sizeof(Checkpoint::MAGIC));
+    putUInt32(Checkpoint::VERSION);
+}
+
+// Description: Appends size bytes at value.
+void CheckpointWriter::put(const void *value, size_t size) {
+    const char *first = static_cast<const char *>(value);
+    bytes.insert(bytes.end(), first, first + size);
+}
+
+// Description: Appends one value.
+void CheckpointWriter::putUInt8(uint8_t value) {
+    put(&value, sizeof(value));
+}
+
+void CheckpointWriter::putUInt32(uint32_t value) {
+    put(&value, sizeof(value));
+}
+
+void CheckpointWriter::putInt32(int32_t value) {
+    put(&value, sizeof(value));
+}
+
+void CheckpointWriter::putInt64(int64_t value) {
+    put(&value, sizeof(value));
+}
+
+void CheckpointWriter::putDouble(double value) {
+    put(&value, sizeof(value));
+}
+
+// Description: Appends the type, time, length and teller of anEvent.
+void CheckpointWriter::putEvent(const Event &anEvent) {
+    putUInt8(anEvent.getType());
+    putInt32(anEvent.getTime());
+    putInt32(anEvent.getLength());
+    putInt32(anEvent.getTeller());
+}
+
+// Description: Appends the number of events, then each of them.
+void CheckpointWriter::putEvents(const std::vector<Event> &someEvents) {
+    putInt64(someEvents.size());
+    bytes.reserve(bytes.size() + someEvents.size() * (sizeof(uint8_t) + 3 * sizeof(int32_t)));
+    for (size_t i = 0; i < someEvents.size(); i++)
+        putEvent(someEvents[i]);
+}
+
+// Description: Returns the size of the checkpoint in bytes.
+size_t CheckpointWriter::getSize() const {
+    return bytes.size();
+}
+
+// Description: Returns the checkpoint, header included, as it would be written.
+const std::vector<char> & CheckpointWriter::getBytes() const {
+    return bytes;
+}
+
+// Description: Writes the checkpoint to fileName, through a temporary file
+//              that replaces fileName once it is complete and on disk.
+void CheckpointWriter::writeTo(const string &fileName) const {
+    string temporaryName = fileName + ".tmp";
+    FILE *file = fopen(temporaryName.c_str(), "wb");
+    if (file == nullptr)
+        throw runtime_error("could not create checkpoint " + temporaryName);
+
+    bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size()
+                   && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    written = (fclose(file) == 0) && written;
+    if (!written || rename(temporaryName.c_str(), fileName.c_str()) != 0) {
+        remove(temporaryName.c_str());
+        throw runtime_error("could not write checkpoint " + fileName);
+    }
+}
+
+
+// Description: Constructor, reads fileName and checks its header.
+CheckpointReader::CheckpointReader(const string &aFileName) : fileName(aFileName) {
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (file == nullptr)
+        throw runtime_error("could not open checkpoint " + fileName);
+
+    char block[1 << 16];
+    size_t bytesRead;
+    while ((bytesRead = fread(block, 1, sizeof(block), file)) > 0)
+        bytes.insert(bytes.end(), block, block + bytesRead);
+    bool failed = ferror(file);
+    fclose(file);
+    if (failed)
+        throw runtime_error("could not read checkpoint " + fileName);
+    checkHeader();
+}
+
+// Description: Constructor, reads back the checkpoint someBytes kept in memory.
+CheckpointReader::CheckpointReader(const std::vector<char> &someBytes, const string &aName)
+    : fileName(aName), bytes(someBytes) {
+    checkHeader();
+}
+
+// Description: Reads the header and checks it is that of a checkpoint.
+void CheckpointReader::checkHeader() {
+    char magic[sizeof(Checkpoint::MAGIC)];
+    if (bytes.size() < sizeof(magic) + sizeof(uint32_t))
+        throw runtime_error(fileName + " is not a checkpoint");
+    get(magic, sizeof(magic));
+    if (memcmp(magic, Checkpoint::MAGIC, sizeof(magic)) != 0 || getUInt32() != Checkpoint::VERSION)
+        throw runtime_error(fileName + " is not a checkpoint");
+}
+
+// Description: Returns the name of the file.
+const string & CheckpointReader::getFileName() const {
+    return fileName;
+}
+
+// Description: Copies the next size bytes into value.
+void CheckpointReader::get(void *value, size_t size) {
+    if (bytes.size() - offset < size)
+        throw runtime_error("checkpoint " + fileName + " is truncated");
+    memcpy(value, bytes.data() + offset, size);
+    offset += size;
+}
+
+// Description: Reads one value.
+uint8_t CheckpointReader::getUInt8() {
+    uint8_t value;
+    get(&value, sizeof(value));
+    return value;
+}
+
+uint32_t CheckpointReader::getUInt32() {
+    uint32_t value;
+    get(&value, sizeof(value));
+    return value;
+}
+
+int32_t CheckpointReader::getInt32() {
+    int32_t value;
+    get(&value, sizeof(value));
+    return value;
+}
+
+int64_t CheckpointReader::getInt64() {
+    int64_t value;
+    get(&value, sizeof(value));
+    return value;
+}
+
+double CheckpointReader::getDouble() {
+    double value;
+    get(&value, sizeof(value));
+    return value;
+}
+
+// Description: Reads an event written by CheckpointWriter::putEvent().
+Event CheckpointReader::getEvent() {
+    char type = getUInt8();
+    int time = getInt32();
+    int length = getInt32();
+    int teller = getInt32();
+    if (type != Event::ARRIVAL && type != Event::DEPARTURE)
+        throw runtime_error("checkpoint " + fileName + " is corrupt");
+    return Event(type, time, length, teller);
+}
+
+// Description: Reads events written by CheckpointWriter::putEvents().
+std::vector<Event> CheckpointReader::getEvents() {
+    int64_t count = getInt64();
+    if (count < 0 || uint64_t(count) > (bytes.size() - offset) / (sizeof(uint8_t) + 3 * sizeof(int32_t)))
+        throw runtime_error("checkpoint " + fileName + " is truncated");
+    std::vector<Event> someEvents;
+    someEvents.reserve(count);
+    for (int64_t i = 0; i < count; i++)
+        someEvents.push_back(getEvent());
+    return someEvents;
+}
+
+// Description: Checks that every byte of the checkpoint has been read.
+void CheckpointReader::finish() const {
+    if (offset != bytes.size())
+        throw runtime_error("checkpoint " + fileName + " is corrupt");
+}
+
+
+volatile sig_atomic_t Checkpointer::stopRequested = 0;
+
+// Description: Requests the run to stop at the next arrival, once it has written a checkpoint.
+void Checkpointer::requestStop() {
+    stopRequested = 1;
+}
+
+// Description: Constructor, a checkpoint to fileName every anEvery customers.
+Checkpointer::Checkpointer(const string &aFileName, long long anEvery)
+    : fileName(aFileName), every(anEvery < 1 ? 1 : anEvery) { }
+
+// Description: Destructor, waits for the last writer.
+Checkpointer::~Checkpointer() {
+    try {
+        finish();
+    } catch (runtime_error &) { }
+}
+
+// Description: Serializes simulation and writes it to the file, in this process.
+void Checkpointer::writeNow(Simulation &simulation) {
+    CheckpointWriter checkpoint;
+    simulation.save(checkpoint);
+    checkpoint.writeTo(fileName);
+}
+
+// Description: Writes a checkpoint of simulation: from a forked child, or in place
+//              if the run is to stop (or fork fails). Returns true if the run is to stop.
+//              A checkpoint due while the last is still being written is skipped.
+//              The child leaves with _exit(), so it flushes none of the parent's
+//              buffered output (e.g. the event log) a second time.
+bool Checkpointer::write(Simulation &simulation) {
+    bool scheduled = nextCheckpoint >= 0;
+    nextCheckpoint = (simulation.getCustomerCount() / every + 1) * every;
+    if (!scheduled && !stopRequested)
+        return false;
+
+    if (stopRequested) {
+        finish();      // One writer at a time: the files are renamed in order
+        checkpointCount++;
+        writeNow(simulation);
+        stopped = true;
+        return true;
+    }
+
+    if (isWriting()) {      // Rather than wait for it, skip this checkpoint
+        skippedCount++;
+        return false;
+    }
+    checkpointCount++;
+
+    pid_t child = fork();
+    if (child == 0) {
+        int status = 0;
+        try {
+            writeNow(simulation);
+        } catch (...) {
+            status = 1;
+        }
+        _exit(status);
+    }
+    if (child < 0)
+        writeNow(simulation);
+    else
+        writer = child;
+    return false;
+}
+
+// Description: Returns true if the writer of the last checkpoint is still running.
+//              A writer that has finished is reaped.
+bool Checkpointer::isWriting() {
+    if (writer < 0)
+        return false;
+
+    int status;
+    pid_t waited = waitpid(writer, &status, WNOHANG);
+    if (waited == 0)
+        return true;
+    writer = -1;
+    if (waited < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        throw runtime_error("could not write checkpoint " + fileName);
+    return false;
+}
+
+// Description: Waits for the writer of the last checkpoint to finish.
+void Checkpointer::finish() {
+    if (writer < 0)
+        return;
+
+    int status;
+    pid_t waited;
+    do {
+        waited = waitpid(writer, &status, 0);
+    } while (waited < 0 && errno == EINTR);
+    writer = -1;
+    if (waited < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        throw runtime_error("could not write checkpoint " + fileName);
+}
+
+// Description: Returns true if the run was stopped by a checkpoint.
+bool Checkpointer::isStopped() const {
+    return stopped;
+}
+
+// Description: Returns the name of the checkpoint file.
+const string & Checkpointer::getFileName() const {
+    return fileName;
+}
+
+// Description: Returns the number of checkpoints taken.
+unsigned int Checkpointer::getCheckpointCount() const {
+    return checkpointCount;
+}
+
+// Description: Returns the number of checkpoints skipped because the last one was
+//              still being written.
+unsigned int Checkpointer::getSkippedCount() const {
+    return skippedCount;
+}
@@ -0,0 +1,213 @@
+/*
+ * Checkpoint.h
+ *
+ * Description: Compact binary checkpoints of a simulation run in progress, so a
+ *              long run can be stopped and resumed where it was (see
+ *              Simulation::resume()): a writer and a reader for the format, and
+ *              Checkpointer, which takes a checkpoint every so many customers.
+ *
+ *              Layout (native byte order):
+ *                  header : magic "BSIMCKP1", uint32 version
+ *                  run    : uint32 tellers, uint32 line discipline, int64 customers,
+ *                           int64 arrivals read
+ *                  state  : int32 current time, int32 last arrival time, statistics
+ *                           (see SimulationStatistics::save()), teller loads,
+ *                           uint8 engine ('E' event driven, 'L' single teller), then
+ *                           the pending events and bank lines of that engine
+ *              The state alone (Simulation::saveState()) also serves as an in-memory
+ *              snapshot (see WhatIfSimulation).
+ *              A checkpoint is taken right after an arrival has been processed and
+ *              before the next one is read, so the input is resumed by skipping the
+ *              arrivals read so far. The event queue and the lines are stored as
+ *              lists of events, not as the arrays of a particular heap: a run may be
+ *              resumed with any scheduler.
+ *
+ *              Writing: Checkpointer forks, and the child process serializes its
+ *              copy-on-write image of the run and writes the file while the parent
+ *              goes on with the event loop, which only pays for the fork. The file is
+ *              written under a temporary name and renamed, so a crash never leaves a
+ *              half-written checkpoint behind. At most one writer runs at a time:
+ *              a checkpoint that falls due while the last one is still being written
+ *              is skipped rather than waited for.
+ *              A stop request (e.g. from a SIGINT handler) makes the next checkpoint
+ *              be written in place, after which the run stops.
+ *
+ * Class Invariant: A reader hands the values back in the order the writer put them.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <csignal>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "Event.h"
+
+class Simulation;
+
+namespace Checkpoint {
+    static char const MAGIC[8] = { 'B', 'S', 'I', 'M', 'C', 'K', 'P', '1' };
+    static uint32_t const VERSION = 2;
+    static uint8_t const EVENT_ENGINE = 'E';           // EventSimulation
+    static uint8_t const SINGLE_TELLER_ENGINE = 'L';   // LindleySimulation
+}
+
+
+// Serializes the values of a checkpoint into memory, then writes them to a file.
+class CheckpointWriter {
+
+    private:
+        std::vector<char> bytes;
+
+        // Description: Appends size bytes at value.
+        void put(const void *value, size_t size);
+
+    public:
+        // Description: Constructor, starts with the header.
+        CheckpointWriter();
+
+        // Description: Appends one value.
+        void putUInt8(uint8_t value);
+        void putUInt32(uint32_t value);
+        void putInt32(int32_t value);
+        void putInt64(int64_t value);
+        void putDouble(double value);
+
+        // Description: Appends the type, time, length and teller of anEvent.
+        void putEvent(const Event &anEvent);
+
+        // Description: Appends the number of events, then each of them.
+        void putEvents(const std::vector<Event> &someEvents);
+
+        // Description: Returns the size of the checkpoint in bytes.
+        size_t getSize() const;
+
+        // Description: Returns the checkpoint, header included, as it would be written.
+        const std::vector<char> &getBytes() const;
+
+        // Description: Writes the checkpoint to fileName, through a temporary file.
+        // Exceptions: Throws runtime_error if the file cannot be written.
+        void writeTo(const std::string &fileName) const;
+};
+
+
+// Reads back the values of a checkpoint file, in the order they were written.
+class CheckpointReader {
+
+    private:
+        std::string fileName;
+        std::vector<char> bytes;
+        size_t offset = 0;          // Next byte to read
+
+        // Description: Copies the next size bytes into value.
+        void get(void *value, size_t size);
+
+        // Description: Reads the header and checks it is that of a checkpoint.
+        void checkHeader();
+
+    public:
+        // Description: Constructor, reads fileName and checks its header.
+        // Exceptions: Throws runtime_error if the file is missing or not a checkpoint.
+        CheckpointReader(const std::string &aFileName);
+
+        // Description: Constructor, reads back the checkpoint someBytes of a
+        //              CheckpointWriter kept in memory, called aName in errors.
+        // Exceptions: Throws runtime_error if someBytes are not a checkpoint.
+        CheckpointReader(const std::vector<char> &someBytes, const std::string &aName);
+
+        // Description: Returns the name of the file.
+        const std::string &getFileName() const;
+
+        // Description: Reads one value.
+        // Exceptions: Throws runtime_error if the checkpoint ends before it.
+        uint8_t getUInt8();
+        uint32_t getUInt32();
+        int32_t getInt32();
+        int64_t getInt64();
+        double getDouble();
+
+        // Description: Reads an event written by CheckpointWriter::putEvent().
+        Event getEvent();
+
+        // Description: Reads events written by CheckpointWriter::putEvents().
+        std::vector<Event> getEvents();
+
+        // Description: Checks that every byte of the checkpoint has been read.
+        // Exceptions: Throws runtime_error if some are left.
+        void finish() const;
+};
+
+
+// Takes a checkpoint of a run every so many customers.
+class Checkpointer {
+
+    private:
+        static volatile sig_atomic_t stopRequested;
+
+        std::string fileName;
+        long long every;                // Customers between two checkpoints
+        long long nextCheckpoint = -1;  // Customer count at which the next one is due, -1 before the first call
+        pid_t writer = -1;              // Child process writing the last checkpoint, if any
+        bool stopped = false;           // A checkpoint was taken to stop the run
+        unsigned int checkpointCount = 0;
+        unsigned int skippedCount = 0;
+
+        // Description: Serializes simulation and writes it to the file, in this process.
+        void writeNow(Simulation &simulation);
+
+        // Description: Returns true if the writer of the last checkpoint is still running.
+        bool isWriting();
+
+    public:
+        static long long const DEFAULT_EVERY = 1000000;
+
+        // Description: Requests the run to stop at the next arrival, once it has written
+        //              a checkpoint. Safe to call from a signal handler.
+        static void requestStop();
+
+        // Description: Constructor, a checkpoint to fileName every anEvery customers.
+        Checkpointer(const std::string &aFileName, long long anEvery = DEFAULT_EVERY);
+
+        // Description: Destructor, waits for the last writer.
+        ~Checkpointer();
+
+        Checkpointer(const Checkpointer &) = delete;
+        Checkpointer & operator=(const Checkpointer &) = delete;
+
+        // Description: Returns true if a checkpoint is due after customerCount customers.
+        // Time Efficiency: O(1)
+        bool isDue(long long customerCount) const {
+            return customerCount >= nextCheckpoint || stopRequested;
+        }
+
+        // Description: Writes a checkpoint of simulation: from a forked child, or in
+        //              place if the run is to stop (or fork fails).
+        //              The first call only sets the schedule, on multiples of the number
+        //              of customers between checkpoints, so a resumed run keeps the
+        //              schedule of the run it resumes. A checkpoint due while the last
+        //              is still being written is skipped; a stop waits for it.
+        //              Returns true if the run is to stop.
+        // Exceptions: Throws runtime_error if the last checkpoint could not be
+        //             written, or this one cannot be written in place.
+        bool write(Simulation &simulation);
+
+        // Description: Waits for the writer of the last checkpoint to finish.
+        // Exceptions: Throws runtime_error if it could not write the checkpoint.
+        void finish();
+
+        // Description: Returns true if the run was stopped by a checkpoint.
+        bool isStopped() const;
+
+        // Description: Returns the name of the checkpoint file.
+        const std::string &getFileName() const;
+
+        // Description: Returns the number of checkpoints taken.
+        unsigned int getCheckpointCount() const;
+
+        // Description: Returns the number of checkpoints skipped because the last one
+        //              was still being written.
+        unsigned int getSkippedCount() const;
+};
+#endif
@@ -0,0 +1,115 @@
+/*
+ * CrossCheck.cpp
+ *
+ * Description: Checks that the analytic single teller engine (Simulation::create(),
+ *              see LindleySimulation) gives exactly the results of the event driven
+ *              engine (Simulation::createEventDriven()) on synthetic workloads (see
+ *              SyntheticArrivals.h) chosen for the cases where they could part:
+ *              arrivals at the same time, transactions of length 0, long idle
+ *              gaps and a saturated teller whose line only grows.
+ *              Every workload is run sequentially and as a parallel scan over
+ *              several threads, for both line disciplines, and must give the same
+ *              customer count and SimulationStatistics (operator==) as the event
+ *              engine. Prints one line per run; exits non-zero if any differ.
+ *              Run by "make check".
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include "Event.h"
+#include "ArrivalReader.h"
+#include "SyntheticArrivals.h"
+#include "Simulation.h"
+#include "TraceLog.h"
+
+using namespace std;
+
+unsigned long long const ARRIVALS = 300000;   // Per workload: enough for several chunks of the parallel scan
+unsigned int const PARALLEL_THREADS = 4;
+
+// A workload to check
+struct Case {
+    const char *name;
+    SyntheticArrivalReader::Workload workload;
+    bool shorten;                     // Take 1 off every length, so that many are 0
+};
+
+// Returns a workload of pattern and service, with the given mean gap and length.
+SyntheticArrivalReader::Workload workloadOf(SyntheticArrivalReader::Pattern pattern, SyntheticArrivalReader::Service service,
+                                            double meanGap, double meanLength, unsigned long long seed) {
+    SyntheticArrivalReader::Workload workload;
+    workload.pattern = pattern;
+    workload.service = service;
+    workload.count = ARRIVALS;
+    workload.meanGap = meanGap;
+    workload.meanLength = meanLength;
+    workload.seed = seed;
+    return workload;
+}
+
+// Generates the arrivals of aCase.
+vector<Event> generate(const Case &aCase) {
+    SyntheticArrivalReader generator(aCase.workload);
+    vector<Event> arrivals;
+    Event newEvent;
+    while (generator.next(newEvent))
+        arrivals.push_back(aCase.shorten ? Event(Event::ARRIVAL, newEvent.getTime(), newEvent.getLength() - 1)
+                                         : newEvent);
+    return arrivals;
+}
+
+// Runs arrivals through simulation, without any output, and returns it.
+unique_ptr<Simulation> simulate(Simulation *simulation, const ArrivalBuffer &arrivals) {
+    unique_ptr<Simulation> owned(simulation);
+    BufferedArrivalReader reader(arrivals);
+    ostringstream unused;
+    TraceLog quiet(unused, TraceLog::SUMMARY);
+    owned->run(reader, quiet);
+    return owned;
+}
+
+int main() {
+    using Reader = SyntheticArrivalReader;
+    vector<Case> cases = {
+        { "typical",                workloadOf(Reader::POISSON, Reader::EXPONENTIAL, 10, 8, 1),         false },
+        { "tied times",             workloadOf(Reader::POISSON, Reader::EXPONENTIAL, 1, 1.5, 2),        true },
+        { "zero lengths",           workloadOf(Reader::POISSON, Reader::EXPONENTIAL, 10, 1.5, 3),       true },
+        { "idle gaps",              workloadOf(Reader::BURSTY, Reader::EXPONENTIAL, 100, 8, 4),         false },
+        { "busy days, idle nights", workloadOf(Reader::DIURNAL, Reader::PARETO, 10, 9, 5),              false },
+        { "heavy tail",             workloadOf(Reader::POISSON, Reader::PARETO, 10, 8, 6),              false },
+        { "saturated",              workloadOf(Reader::POISSON, Reader::EXPONENTIAL, 10, 12, 7),        false },
+    };
+    Simulation::LineDiscipline const disciplines[] = { Simulation::SHARED_LINE, Simulation::SHORTEST_LINE };
+    unsigned int const threadCounts[] = { 1, PARALLEL_THREADS };
+
+    bool identical = true;
+    try {
+        for (const Case &aCase : cases) {
+            ArrivalBuffer arrivals(generate(aCase));
+            for (Simulation::LineDiscipline discipline : disciplines) {
+                unique_ptr<Simulation> reference = simulate(Simulation::createEventDriven(1, discipline), arrivals);
+                for (unsigned int threads : threadCounts) {
+                    Simulation *lindley = Simulation::create(1, discipline);
+                    lindley->setThreadCount(threads);
+                    unique_ptr<Simulation> simulation = simulate(lindley, arrivals);
+
+                    bool same = simulation->getCustomerCount() == reference->getCustomerCount()
+                                && simulation->getStatistics() == reference->getStatistics();
+                    identical = identical && same;
+                    cout << aCase.name << ", " << (discipline == Simulation::SHARED_LINE ? "shared" : "shortest")
+                         << " line, " << threads << (threads == 1 ? " thread" : " threads") << ", "
+                         << arrivals.getElementCount() << " arrivals: " << (same ? "identical" : "DIFFERENT") << endl;
+                }
+            }
+        }
+    }
+    catch (runtime_error &anException) {
+        cerr << anException.what() << endl;
+        return 1;
+    }
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+/*
+ * DaryHeap.cpp
+ *
+ * Description: Min d-ary Heap ADT class, a drop-in alternative to BinaryHeap
+ *              for large event queues. Each node has Arity children and the
+ *              children of a node are stored next to each other, starting on a
+ *              cache line boundary: with Arity 4 and 16 byte Events, all the
+ *              children of a node share one 64 byte cache line, so each level
+ *              of reHeapDown touches one cache line instead of one per child.
+ *              Picking the smallest of four Event children compares their packed
+ *              keys without branches.
+ *
+ * Class Invariant:  Always a Min d-ary Heap.
+ *                   elements[0 .. elementCount-1] are constructed, the
+ *                   rest of the storage is raw memory.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "DaryHeap.h"  // Header file
+
+
+// Description: Returns the index (0 to 3) of the first of four consecutive events
+//              that comes out of the event queue first.
+//              A two round tournament on the packed keys: the compiler turns each
+//              round into conditional moves, so there are no branches to mispredict.
+//              Among equal keys the earlier event wins, as in indexOfMinChild().
+inline unsigned int EventOrder::indexOfMinOfFour(const Event *children) {
+   unsigned int firstPair = (children[1].key < children[0].key) ? 1 : 0;
+   unsigned int secondPair = (children[3].key < children[2].key) ? 3 : 2;
+   return (children[secondPair].key < children[firstPair].key) ? secondPair : firstPair;
+}
+
+
+// Description: Constructor
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+DaryHeap<ElementType, Arity, Compare, Growth>::DaryHeap() {
+   allocate(INITIAL_CAPACITY);
+}
+
+// Description: Destructor
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+DaryHeap<ElementType, Arity, Compare, Growth>::~DaryHeap() {
+   for (unsigned int i = 0; i < elementCount; i++)
+      elements[i].~ElementType();
+   free(storage);
+}
+
+// Description: Raw storage for newCapacity elements, with the children
+//              of every node starting on a cache line boundary.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+void DaryHeap<ElementType, Arity, Compare, Growth>::allocate(unsigned int newCapacity) {
+   size_t bytes = (newCapacity + Arity - 1) * sizeof(ElementType);
+   bytes = (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+   storage = (ElementType *)aligned_alloc(CACHE_LINE, bytes);
+   if (storage == nullptr)
+      throw std::bad_alloc();
+   elements = storage + (Arity - 1);
+   capacity = newCapacity;
+}
+
+// Description: Returns the number of elements in the Heap.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+unsigned int DaryHeap<ElementType, Arity, Compare, Growth>::getElementCount() const {
+   return elementCount;
+}
+
+// Description: Inserts newElement into the Heap.
+//              It returns true if successful, otherwise false.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+bool DaryHeap<ElementType, Arity, Compare, Growth>::insert(const ElementType &newElement) {
+   if (elementCount == capacity) //If array is full resize it
+      resize(Growth::grow(capacity));
+
+   new (&elements[elementCount]) ElementType(newElement);
+   elementCount++;
+   reHeapUp(elementCount - 1);
+   return true;
+}
+
+// Description: Put the array back into a Min Heap by moving the hole
+//              at indexOfBottom up until the element in it fits.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+void DaryHeap<ElementType, Arity, Compare, Growth>::reHeapUp(unsigned int indexOfBottom) {
+   if (indexOfBottom == 0)
+      return;
+
+   ElementType element = std::move(elements[indexOfBottom]);
+   while (indexOfBottom > 0) {
+      unsigned int indexOfParent = (indexOfBottom - 1) / Arity;
+      if (!compare(element, elements[indexOfParent]))
+         break;
+      elements[indexOfBottom] = std::move(elements[indexOfParent]);
+      indexOfBottom = indexOfParent;
+   }
+   elements[indexOfBottom] = std::move(element);
+}
+
+// Description: Retrieves (but does not remove) the necessary element,
+//              without checking that there is one.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+ElementType & DaryHeap<ElementType, Arity, Compare, Growth>::retrieveUnchecked() const {
+   return elements[0];
+}
+
+// Description: Retrieves (but does not remove) the necessary element.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+ElementType & DaryHeap<ElementType, Arity, Compare, Growth>::retrieve() const {
+   if (elementCount == 0)
+      throw EmptyDataCollectionException("retrieve() called with an empty DaryHeap.");
+   return retrieveUnchecked();
+}
+
+// Description: Removes (but does not return) the necessary element,
+//              without checking that there is one.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+void DaryHeap<ElementType, Arity, Compare, Growth>::removeUnchecked() {
+   elementCount--;
+   ElementType last = std::move(elements[elementCount]);
+   elements[elementCount].~ElementType();
+   if (elementCount > 0)
+      reHeapDown(0, last); //Restore heap order
+
+   unsigned int newCapacity = Growth::shrink(capacity, elementCount, minimumCapacity);
+   if (newCapacity != capacity)
+      resize(newCapacity); //Shrink array if necessary
+}
+
+// Description: Removes (but does not return) the necessary element.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+void DaryHeap<ElementType, Arity, Compare, Growth>::remove() {
+   if (elementCount == 0)
+      throw EmptyDataCollectionException("remove() called with an empty DaryHeap.");
+   removeUnchecked();
+}
+
+// Description: Returns the index of the smallest of the count children starting at firstChild.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+unsigned int DaryHeap<ElementType, Arity, Compare, Growth>::indexOfMinChild(unsigned int firstChild, unsigned int count) const {
+   if constexpr (Arity == 4 && std::is_same<ElementType, Event>::value && std::is_base_of<EventOrder, Compare>::value) {
+      if (count == 4)
+         return firstChild + EventOrder::indexOfMinOfFour(&elements[firstChild]);
+   }
+
+   unsigned int indexOfMin = firstChild;
+   for (unsigned int i = firstChild + 1; i < firstChild + count; i++)
+      if (!compare(elements[indexOfMin], elements[i]))
+         indexOfMin = i;
+   return indexOfMin;
+}
+
+// Description: Put the array back into a Min Heap by moving the hole
+//              at indexOfRoot down until element fits in it.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+void DaryHeap<ElementType, Arity, Compare, Growth>::reHeapDown(unsigned int indexOfRoot, ElementType &element) {
+   while (true) {
+      unsigned int firstChild = Arity * indexOfRoot + 1;
+      if (firstChild >= elementCount)
+         break;
+
+      unsigned int count = (elementCount - firstChild < Arity) ? elementCount - firstChild : Arity;
+      unsigned int indexOfMin = indexOfMinChild(firstChild, count);
+      if (compare(element, elements[indexOfMin]))
+         break;
+
+      // Move the smallest child up into the hole
+      elements[indexOfRoot] = std::move(elements[indexOfMin]);
+      indexOfRoot = indexOfMin;
+   }
+   elements[indexOfRoot] = std::move(element);
+}
+
+// Description: Resize the array, moving the elements into the new storage.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+void DaryHeap<ElementType, Arity, Compare, Growth>::resize(unsigned int newCapacity) {
+   ElementType *oldStorage = storage;
+   ElementType *oldElements = elements;
+
+   allocate(newCapacity);
+   for (unsigned int i = 0; i < elementCount; i++) {
+      new (&elements[i]) ElementType(std::move(oldElements[i]));
+      oldElements[i].~ElementType();
+   }
+   free(oldStorage);
+   reallocationCount++;
+}
+
+// Description: Makes room for at least newCapacity elements and keeps at least that much room.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+void DaryHeap<ElementType, Arity, Compare, Growth>::reserve(unsigned int newCapacity) {
+   if (newCapacity > minimumCapacity)
+      minimumCapacity = newCapacity;
+   if (newCapacity > capacity)
+      resize(newCapacity);
+}
+
+// Description: Returns the number of elements the Heap holds without reallocating.
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+unsigned int DaryHeap<ElementType, Arity, Compare, Growth>::getCapacity() const {
+   return capacity;
+}
+
+// Description: Returns the number of times the storage was reallocated (grown or shrunk).
+template <class ElementType, unsigned int Arity, class Compare, class Growth>
+unsigned long long DaryHeap<ElementType, Arity, Compare, Growth>::getReallocationCount() const {
+   return reallocationCount;
+}
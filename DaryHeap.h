@@ -0,0 +1,116 @@
+/*
+ * DaryHeap.h
+ *
+ * Description: Min d-ary Heap ADT class, a drop-in alternative to BinaryHeap
+ *              for large event queues. Each node has Arity children and the
+ *              children of a node are stored next to each other, starting on a
+ *              cache line boundary: with Arity 4 and 16 byte Events, all the
+ *              children of a node share one 64 byte cache line, so each level
+ *              of reHeapDown touches one cache line instead of one per child.
+ *              Picking the smallest of four Event children compares their packed
+ *              keys without branches.
+ *
+ * Class Invariant:  Always a Min d-ary Heap.
+ *                   elements[0 .. elementCount-1] are constructed, the
+ *                   rest of the storage is raw memory.
+ */
+
+#ifndef DaryHeap_H
+#define DaryHeap_H
+
+#include "Event.h"
+#include "HeapOrder.h"
+#include "GrowthPolicy.h"
+#include "EmptyDataCollectionException.h"
+
+
+template <class ElementType, unsigned int Arity = 4, class Compare = HeapOrder<ElementType>, class Growth = DefaultGrowth>
+class DaryHeap {
+
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+    private:
+        static unsigned int const INITIAL_CAPACITY = 64;   // Constant INITIAL_CAPACITY
+        static unsigned int const CACHE_LINE = 64;         // Alignment of each group of children
+
+        ElementType *storage;          // Raw, cache line aligned memory
+        ElementType *elements;         // storage + Arity - 1: node i's children start at elements[Arity*i + 1]
+        unsigned int elementCount = 0; // Number of elements in the Heap
+        unsigned int capacity = INITIAL_CAPACITY;
+        unsigned int minimumCapacity = INITIAL_CAPACITY; // The storage never shrinks below this (see reserve())
+        unsigned long long reallocationCount = 0;         // Number of times the storage was reallocated
+        Compare compare;               // Heap order
+
+        // Description: Returns the index of the smallest of the count children starting at firstChild.
+        unsigned int indexOfMinChild(unsigned int firstChild, unsigned int count) const;
+
+        // Description: Put the array back into a Min Heap by moving the hole
+        //              at indexOfRoot down until element fits in it.
+        void reHeapDown(unsigned int indexOfRoot, ElementType &element);
+
+        // Description: Put the array back into a Min Heap by moving the hole
+        //              at indexOfBottom up until the element in it fits.
+        void reHeapUp(unsigned int indexOfBottom);
+
+        void allocate(unsigned int newCapacity);   // Raw storage for newCapacity elements
+        void resize(unsigned int newCapacity);     // To resize the array
+
+    public:
+        // Description: Constructor
+        DaryHeap();
+
+        // Description: Destructor
+        ~DaryHeap();
+
+        DaryHeap(const DaryHeap &) = delete;
+        DaryHeap & operator=(const DaryHeap &) = delete;
+
+        // Description: Returns the number of elements in the Heap.
+        // Time Efficiency: O(1)
+        unsigned int getElementCount() const;
+
+        // Description: Inserts newElement into the Heap.
+        //              It returns true if successful, otherwise false.
+        // Time Efficiency: O(log_d n)
+        bool insert(const ElementType &newElement);
+
+        // Description: Removes (but does not return) the necessary element.
+        // Precondition: This Heap is not empty.
+        // Exceptions: Throws EmptyDataCollectionException if this Heap is empty.
+        // Time Efficiency: O(d log_d n)
+        void remove();
+
+        // Description: Retrieves (but does not remove) the necessary element.
+        // Precondition: This Heap is not empty.
+        // Exceptions: Throws EmptyDataCollectionException if this Heap is empty.
+        // Time Efficiency: O(1)
+        ElementType &retrieve() const;
+
+        // Description: Same as remove() and retrieve(), but without checking that the Heap
+        //              is not empty, for callers that have already checked it (the event loop).
+        // Precondition: This Heap is not empty. Otherwise the behaviour is undefined.
+        // Time Efficiency: O(d log_d n), and O(1)
+        void removeUnchecked();
+        ElementType &retrieveUnchecked() const;
+
+        // Description: Makes room for at least newCapacity elements, so the Heap can
+        //              grow to that many without reallocating, and keeps at least that
+        //              much room from then on.
+        // Time Efficiency: O(n) if the storage is reallocated, otherwise O(1)
+        void reserve(unsigned int newCapacity);
+
+        // Description: Returns the number of elements the Heap holds without reallocating.
+        // Time Efficiency: O(1)
+        unsigned int getCapacity() const;
+
+        // Description: Returns the number of times the storage was reallocated (grown or shrunk).
+        // Time Efficiency: O(1)
+        unsigned long long getReallocationCount() const;
+};
+
+// Four-ary heap, the layout that fits the children of an Event node in one cache line
+template <class ElementType>
+using QuaternaryHeap = DaryHeap<ElementType, 4>;
+
+#include "DaryHeap.cpp"
+#endif
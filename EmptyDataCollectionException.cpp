@@ -8,7 +8,10 @@
  */
  
 #include "EmptyDataCollectionException.h"  
+#include "Instrumentation.h"
 
 // Constructor
 EmptyDataCollectionException::EmptyDataCollectionException(const string& message): 
-logic_error("EmptyDataCollectionException: " + message) {}  
+logic_error("EmptyDataCollectionException: " + message) {
+    BSIM_COUNT(EXCEPTIONS_THROWN);
+}  
@@ -4,7 +4,8 @@
  * Description: Models arrival and departure events.
  *
  * Class Invariant: Arrival events have type 'A'.
- *                  Departure events have type 'D'.
+ *                  Departure events have type 'D' and carry the teller
+ *                  the customer is leaving.
  *
  * Author: AL
  * Last Modified: Nov. 2023
@@ -18,19 +19,21 @@ using std::endl;
 
 
 // Constructor
-Event::Event() : type(ARRIVAL) { }
+Event::Event() : key(makeKey(ARRIVAL, 0)) { }
 
-Event::Event(char aType, int aTime) : type(aType), time(aTime) { }
+Event::Event(char aType, int aTime) : key(makeKey(aType, aTime)) { }
 
-Event::Event(char aType, int aTime, int aLength) : type(aType), time(aTime), length(aLength) { }
+Event::Event(char aType, int aTime, int aLength) : key(makeKey(aType, aTime)), length(aLength) { }
+
+Event::Event(char aType, int aTime, int aLength, int aTeller) : key(makeKey(aType, aTime)), length(aLength), teller(aTeller) { }
 
 // Getters
 char Event::getType() const {
-   return type;
+   return typeOfKey(key);
 }
 
 int Event::getTime() const {
-   return time;
+   return timeOfKey(key);
 }
 
 // Postcondition: The length makes sense only when the type is "A".
@@ -38,40 +41,51 @@ int Event::getLength() const {
    return length;
 }
 
+// Postcondition: The teller makes sense only when the type is "D".
+int Event::getTeller() const {
+   return teller;
+}
+
+// Postcondition: Events come out of the event queue in increasing key order.
+uint64_t Event::getKey() const {
+   return key;
+}
+
 // Setters
 // Not expected to be used in this simulation
 void Event::setType( char aType ) {
-   type = aType;
+   key = makeKey(aType, getTime());
    return;
 }
 
 void Event::setTime( int aTime ) {
-   time = aTime;
+   key = makeKey(getType(), aTime);
    return;
 }
 
 void Event::setLength( int aLength ) {
-   if( type == ARRIVAL )
+   if( getType() == ARRIVAL )
       length = aLength;
    else
       length = 0;
    return;
 }
 
+void Event::setTeller( int aTeller ) {
+   teller = aTeller;
+   return;
+}
+
 // Description: Return true if this event is an arrival event, false otherwise.
 bool Event::isArrival(){
-   return type == ARRIVAL;
+   return getType() == ARRIVAL;
 }
 
 // Overloaded Operators
 // Description: Comparison <= operator. 
-bool Event::operator<=(const Event& rhs) {
-
-   // Compare both Event objects
-   if (time == rhs.getTime() )
-      return (type == rhs.getType()) || (type == ARRIVAL && rhs.getType() == DEPARTURE);
-   else
-      return time < rhs.getTime();
+//              Compares the keys: by time, then ARRIVAL before DEPARTURE.
+bool Event::operator<=(const Event& rhs) const {
+   return key <= rhs.key;
 } 
 
 // For Testing Purposes
@@ -3,8 +3,15 @@
  * 
  * Description: Models arrival and departure events.
  *
+ *              The time and type are packed into one 64 bit key whose integer
+ *              order is the event order: the time (biased to unsigned) in the
+ *              high half, the type in the low byte, so at equal times an
+ *              arrival ('A') comes before a departure ('D'). Comparing two
+ *              events is then a single integer comparison.
+ *
  * Class Invariant: Arrival events have type 'A'.
- *                  Departure events have type 'D'.
+ *                  Departure events have type 'D' and carry the teller
+ *                  the customer is leaving.
  *
  * Author: AL
  * Last Modified: Nov. 2023
@@ -13,42 +20,84 @@
 #ifndef EVENT_H
 #define EVENT_H
 
+#include <cstdint>
+#include "HeapOrder.h"
+
 class Event {
 
+   friend struct EventOrder;
+   template <class Growth> friend class EventHeap;   // Store the fields of an Event in separate arrays
+   template <class Growth> friend class EventLine;
+
 private:
-   char type;
-   int time = 0;
+   uint64_t key;   // (time + 2^31) << 32 | type
    int length = 0; //only used for arrival events
+   int teller = 0; //only used for departure events: teller the customer leaves
    
 public:
    constexpr static char ARRIVAL = 'A';
    constexpr static char DEPARTURE = 'D';
+
+   // Description: Returns the key of an event of type aType at time aTime.
+   static uint64_t makeKey(char aType, int aTime) {
+      return (uint64_t)((uint32_t)aTime ^ 0x80000000u) << 32 | (unsigned char)aType;
+   }
+
+   // Description: Returns the type of the events with key aKey.
+   static char typeOfKey(uint64_t aKey) {
+      return (char)(aKey & 0xFF);
+   }
+
+   // Description: Returns the time of the events with key aKey.
+   static int timeOfKey(uint64_t aKey) {
+      return (int)((uint32_t)(aKey >> 32) ^ 0x80000000u);
+   }
    
    // Constructor
    Event();
    Event(char type, int time);
    Event(char type, int time, int length);
+   Event(char type, int time, int length, int teller);
    
    // Getters
    char getType() const;
    int getTime() const;
    int getLength() const;
+   int getTeller() const;
+   uint64_t getKey() const;
     
    // Setters
    void setType( char aType );
    void setTime( int aTime );
    void setLength( int aLength );
+   void setTeller( int aTeller );
    
    // Description: Return true if this event is an arrival event, false otherwise.
    bool isArrival();
 
    // Overloaded Operators
    // Description: Comparison <= operator. 
-   bool operator<=(const Event& rhs);
+   bool operator<=(const Event& rhs) const;
 
    // For Testing Purposes
    // Description: Prints the content of "this". 
    void print() const;
 
 };
+
+// Description: Order of events in the event queue, the same as operator<=
+//              (by time, arrivals before departures at equal times) but
+//              inlined into the heaps instead of calling operator<=.
+struct EventOrder {
+   bool operator()(const Event& lhs, const Event& rhs) const {
+      return lhs.key <= rhs.key;
+   }
+
+   // Description: Returns the index of the first of four consecutive events that
+   //              comes out first, without branches (see DaryHeap.cpp).
+   static inline unsigned int indexOfMinOfFour(const Event* children);
+};
+
+template <>
+struct HeapOrder<Event> : EventOrder { };
 #endif
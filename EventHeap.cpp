@@ -0,0 +1,207 @@
+/*
+ * EventHeap.cpp
+ *
+ * Description: Min Binary Heap of Events stored as a structure of arrays, a drop-in
+ *              alternative to BinaryHeap<Event> behind the PriorityQueue of events.
+ *              Sifting only ever compares event keys (time and type, see Event.h),
+ *              so the heap itself is a dense array of keys, with a parallel array
+ *              of payload slots. The payload (length and teller) is written to its
+ *              slot once on insert and read once when the event comes out: it does
+ *              not move while the key travels up and down the heap.
+ *
+ * Class Invariant:  keys[0 .. elementCount-1] is always a Min Binary Heap.
+ *                   slots[i] is the payload slot of keys[i]; slots[elementCount ..
+ *                   capacity-1] are the free slots.
+ */
+
+#include "EventHeap.h"  // Header file
+
+
+// Description: Constructor
+template <class Growth>
+EventHeap<Growth>::EventHeap() {
+   keys = new uint64_t[INITIAL_CAPACITY];
+   slots = new uint32_t[INITIAL_CAPACITY];
+   lengths = new int[INITIAL_CAPACITY];
+   tellers = new int[INITIAL_CAPACITY];
+   for (unsigned int i = 0; i < INITIAL_CAPACITY; i++)
+      slots[i] = i;
+}
+
+// Description: Destructor
+template <class Growth>
+EventHeap<Growth>::~EventHeap() {
+   delete[] keys;
+   delete[] slots;
+   delete[] lengths;
+   delete[] tellers;
+}
+
+// Description: Returns the number of events in the Heap.
+template <class Growth>
+unsigned int EventHeap<Growth>::getElementCount() const {
+   return elementCount;
+}
+
+// Description: Inserts newElement into the Heap.
+//              Its payload goes into the free slot at the bottom of the heap,
+//              then only its key and slot number move up.
+template <class Growth>
+bool EventHeap<Growth>::insert(const Event &newElement) {
+   if (elementCount == capacity) //If the arrays are full resize them
+      resize(Growth::grow(capacity));
+
+   uint32_t slot = slots[elementCount];
+   lengths[slot] = newElement.length;
+   tellers[slot] = newElement.teller;
+
+   elementCount++;
+   reHeapUp(elementCount - 1, newElement.key, slot);
+   return true;
+}
+
+// Description: Put the keys back into a Min Binary Heap by moving the hole
+//              at indexOfBottom up until key (with its slot) fits in it.
+template <class Growth>
+void EventHeap<Growth>::reHeapUp(unsigned int indexOfBottom, uint64_t key, uint32_t slot) {
+   while (indexOfBottom > 0) {
+      unsigned int indexOfParent = (indexOfBottom - 1) / 2;
+      if (!(key <= keys[indexOfParent]))
+         break;
+
+      // Move the parent down into the hole
+      keys[indexOfBottom] = keys[indexOfParent];
+      slots[indexOfBottom] = slots[indexOfParent];
+      indexOfBottom = indexOfParent;
+   }
+   keys[indexOfBottom] = key;
+   slots[indexOfBottom] = slot;
+}
+
+// Description: Retrieves (but does not remove) the necessary element,
+//              without checking that there is one.
+template <class Growth>
+Event & EventHeap<Growth>::retrieveUnchecked() const {
+   uint32_t slot = slots[0];
+   front.key = keys[0];
+   front.length = lengths[slot];
+   front.teller = tellers[slot];
+   return front;
+}
+
+// Description: Retrieves (but does not remove) the first event.
+template <class Growth>
+Event & EventHeap<Growth>::retrieve() const {
+   if (elementCount == 0)
+      throw EmptyDataCollectionException("retrieve() called with an empty EventHeap.");
+   return retrieveUnchecked();
+}
+
+// Description: Removes (but does not return) the necessary element,
+//              without checking that there is one.
+template <class Growth>
+void EventHeap<Growth>::removeUnchecked() {
+   elementCount--;
+   uint32_t freedSlot = slots[0];
+   uint64_t lastKey = keys[elementCount];
+   uint32_t lastSlot = slots[elementCount];
+   if (elementCount > 0)
+      reHeapDown(0, lastKey, lastSlot); //Restore heap order
+   slots[elementCount] = freedSlot;
+
+   unsigned int newCapacity = Growth::shrink(capacity, elementCount, minimumCapacity);
+   if (newCapacity != capacity)
+      resize(newCapacity); //Shrink the arrays if necessary
+}
+
+// Description: Removes (but does not return) the first event.
+//              Its slot is freed at the position the last key leaves empty.
+template <class Growth>
+void EventHeap<Growth>::remove() {
+   if (elementCount == 0)
+      throw EmptyDataCollectionException("remove() called with an empty EventHeap.");
+   removeUnchecked();
+}
+
+// Description: Put the keys back into a Min Binary Heap by moving the hole
+//              at indexOfRoot down until key (with its slot) fits in it.
+//              Picks children exactly like BinaryHeap, so ties come out in the same order.
+template <class Growth>
+void EventHeap<Growth>::reHeapDown(unsigned int indexOfRoot, uint64_t key, uint32_t slot) {
+   while (true) {
+      unsigned int indexOfLeftChild = 2 * indexOfRoot + 1;
+      unsigned int indexOfRightChild = indexOfLeftChild + 1;
+      if (indexOfLeftChild >= elementCount)
+         break;
+
+      uint64_t minKey = key;
+      unsigned int indexOfMinChild = indexOfRoot;
+      if (!(key <= keys[indexOfLeftChild])) {
+         minKey = keys[indexOfLeftChild];
+         indexOfMinChild = indexOfLeftChild;
+      }
+      if (indexOfRightChild < elementCount && !(minKey <= keys[indexOfRightChild]))
+         indexOfMinChild = indexOfRightChild;
+
+      if (indexOfMinChild == indexOfRoot)
+         break;
+
+      // Move the smallest child up into the hole
+      keys[indexOfRoot] = keys[indexOfMinChild];
+      slots[indexOfRoot] = slots[indexOfMinChild];
+      indexOfRoot = indexOfMinChild;
+   }
+   keys[indexOfRoot] = key;
+   slots[indexOfRoot] = slot;
+}
+
+// Description: Resize the arrays.
+//              The payloads are packed into slots 0 .. elementCount-1 on the way,
+//              which is the only time a payload moves.
+template <class Growth>
+void EventHeap<Growth>::resize(unsigned int newCapacity) {
+   uint64_t *newKeys = new uint64_t[newCapacity];
+   uint32_t *newSlots = new uint32_t[newCapacity];
+   int *newLengths = new int[newCapacity];
+   int *newTellers = new int[newCapacity];
+
+   for (unsigned int i = 0; i < elementCount; i++) {
+      newKeys[i] = keys[i];
+      newLengths[i] = lengths[slots[i]];
+      newTellers[i] = tellers[slots[i]];
+   }
+   for (unsigned int i = 0; i < newCapacity; i++)
+      newSlots[i] = i;
+
+   delete[] keys;
+   delete[] slots;
+   delete[] lengths;
+   delete[] tellers;
+   keys = newKeys;
+   slots = newSlots;
+   lengths = newLengths;
+   tellers = newTellers;
+   capacity = newCapacity;
+   reallocationCount++;
+}
+
+// Description: Makes room for at least newCapacity events and keeps at least that much room.
+template <class Growth>
+void EventHeap<Growth>::reserve(unsigned int newCapacity) {
+   if (newCapacity > minimumCapacity)
+      minimumCapacity = newCapacity;
+   if (newCapacity > capacity)
+      resize(newCapacity);
+}
+
+// Description: Returns the number of events the Heap holds without reallocating.
+template <class Growth>
+unsigned int EventHeap<Growth>::getCapacity() const {
+   return capacity;
+}
+
+// Description: Returns the number of times the arrays were reallocated (grown or shrunk).
+template <class Growth>
+unsigned long long EventHeap<Growth>::getReallocationCount() const {
+   return reallocationCount;
+}
@@ -0,0 +1,111 @@
+/*
+ * EventHeap.h
+ *
+ * Description: Min Binary Heap of Events stored as a structure of arrays, a drop-in
+ *              alternative to BinaryHeap<Event> behind the PriorityQueue of events.
+ *              Sifting only ever compares event keys (time and type, see Event.h),
+ *              so the heap itself is a dense array of keys, with a parallel array
+ *              of payload slots. The payload (length and teller) is written to its
+ *              slot once on insert and read once when the event comes out: it does
+ *              not move while the key travels up and down the heap.
+ *              Comparisons read twice as many keys per cache line as whole Events,
+ *              but every move also writes the slot array, so it pays off when the
+ *              payload is large compared to the key (see heapbench for Events).
+ *              Equal keys come out in the same order as from BinaryHeap<Event>.
+ *
+ * Class Invariant:  keys[0 .. elementCount-1] is always a Min Binary Heap.
+ *                   slots[i] is the payload slot of keys[i]; slots[elementCount ..
+ *                   capacity-1] are the free slots.
+ */
+
+#ifndef EVENT_HEAP_H
+#define EVENT_HEAP_H
+
+#include <cstdint>
+#include "Event.h"
+#include "GrowthPolicy.h"
+#include "EmptyDataCollectionException.h"
+
+
+template <class Growth = DefaultGrowth>
+class EventHeap {
+
+    private:
+        static unsigned int const INITIAL_CAPACITY = 6; // Constant INITIAL_CAPACITY
+
+        uint64_t *keys;               // Event keys, in heap order
+        uint32_t *slots;              // Payload slot of each key, then the free slots
+        int *lengths;                 // Payload: length of the event in each slot
+        int *tellers;                 // Payload: teller of the event in each slot
+        mutable Event front;          // The first event, put back together by retrieve()
+
+        unsigned int elementCount = 0;
+        unsigned int capacity = INITIAL_CAPACITY;
+        unsigned int minimumCapacity = INITIAL_CAPACITY; // The arrays never shrink below this (see reserve())
+        unsigned long long reallocationCount = 0;        // Number of times the arrays were reallocated
+
+        // Description: Put the keys back into a Min Binary Heap by moving the hole
+        //              at indexOfRoot down until key (with its slot) fits in it.
+        void reHeapDown(unsigned int indexOfRoot, uint64_t key, uint32_t slot);
+
+        // Description: Put the keys back into a Min Binary Heap by moving the hole
+        //              at indexOfBottom up until key (with its slot) fits in it.
+        void reHeapUp(unsigned int indexOfBottom, uint64_t key, uint32_t slot);
+
+        void resize(unsigned int newCapacity); // To resize the arrays, packing the payloads
+
+    public:
+        // Description: Constructor
+        EventHeap();
+
+        // Description: Destructor
+        ~EventHeap();
+
+        EventHeap(const EventHeap &) = delete;
+        EventHeap & operator=(const EventHeap &) = delete;
+
+        // Description: Returns the number of events in the Heap.
+        // Time Efficiency: O(1)
+        unsigned int getElementCount() const;
+
+        // Description: Inserts newElement into the Heap.
+        //              It returns true if successful, otherwise false.
+        // Time Efficiency: O(log2 n)
+        bool insert(const Event &newElement);
+
+        // Description: Removes (but does not return) the first event.
+        // Precondition: This Heap is not empty.
+        // Exceptions: Throws EmptyDataCollectionException if this Heap is empty.
+        // Time Efficiency: O(log2 n)
+        void remove();
+
+        // Description: Retrieves (but does not remove) the first event.
+        //              The reference stays valid until the next call on the Heap.
+        // Precondition: This Heap is not empty.
+        // Exceptions: Throws EmptyDataCollectionException if this Heap is empty.
+        // Time Efficiency: O(1)
+        Event &retrieve() const;
+
+        // Description: Same as remove() and retrieve(), but without checking that the Heap
+        //              is not empty, for callers that have already checked it (the event loop).
+        // Precondition: This Heap is not empty. Otherwise the behaviour is undefined.
+        // Time Efficiency: O(log2 n), and O(1)
+        void removeUnchecked();
+        Event &retrieveUnchecked() const;
+
+        // Description: Makes room for at least newCapacity events, so the Heap can
+        //              grow to that many without reallocating, and keeps at least that
+        //              much room from then on.
+        // Time Efficiency: O(n) if the arrays are reallocated, otherwise O(1)
+        void reserve(unsigned int newCapacity);
+
+        // Description: Returns the number of events the Heap holds without reallocating.
+        // Time Efficiency: O(1)
+        unsigned int getCapacity() const;
+
+        // Description: Returns the number of times the arrays were reallocated (grown or shrunk).
+        // Time Efficiency: O(1)
+        unsigned long long getReallocationCount() const;
+};
+#include "EventHeap.cpp"
+#endif
@@ -0,0 +1,140 @@
+/*
+ * EventLine.cpp
+ *
+ * Description: FIFO Queue of arrival events stored as a structure of arrays,
+ *              a drop-in alternative to Queue<Event> for the bank line.
+ *              A customer waiting in line only needs the time they arrived and
+ *              the length of their transaction, so the line keeps two int arrays
+ *              and nothing else.
+ *
+ * Class Invariant: FIFO order
+ *                  Only arrival events: the type and teller are not kept.
+ */
+
+#include <utility>
+#include "EventLine.h"
+
+// Description: Constructor
+template <class Growth>
+EventLine<Growth>::EventLine() {
+    times = new int[INITIAL_CAPACITY];
+    lengths = new int[INITIAL_CAPACITY];
+}
+
+// Description: Destructor
+template <class Growth>
+EventLine<Growth>::~EventLine() {
+    delete[] times;
+    delete[] lengths;
+}
+
+// Description: Resize the arrays, front customer first.
+template <class Growth>
+void EventLine<Growth>::resize(unsigned int newCapacity) {
+    int *newTimes = new int[newCapacity];
+    int *newLengths = new int[newCapacity];
+    for (unsigned int i = 0; i < elementCount; i++) {
+        unsigned int index = (frontindex + i) % capacity;
+        newTimes[i] = times[index];
+        newLengths[i] = lengths[index];
+    }
+
+    delete[] times;
+    delete[] lengths;
+    times = newTimes;
+    lengths = newLengths;
+    frontindex = 0;
+    backindex = elementCount % newCapacity;
+    capacity = newCapacity;
+    reallocationCount++;
+}
+
+// Description: Returns true if this line is empty, otherwise false.
+template <class Growth>
+bool EventLine<Growth>::isEmpty() const {
+    return elementCount == 0;
+}
+
+// Description: Inserts newElement at the back of this line
+//              and returns true if successful, otherwise false.
+template <class Growth>
+bool EventLine<Growth>::enqueue(const Event &newElement) {
+    if (elementCount == capacity)
+        resize(Growth::grow(capacity));
+
+    times[backindex] = Event::timeOfKey(newElement.key);
+    lengths[backindex] = newElement.length;
+    elementCount++;
+    backindex = (backindex + 1) % capacity;
+    return true;
+}
+
+// Description: Removes (but does not return) the customer at the front of this line,
+//              without checking that there is one.
+template <class Growth>
+void EventLine<Growth>::dequeueUnchecked() {
+    elementCount--;
+    frontindex = (frontindex + 1) % capacity;
+
+    unsigned int newCapacity = Growth::shrink(capacity, elementCount, minimumCapacity);
+    if (newCapacity != capacity)
+        resize(newCapacity);
+}
+
+// Description: Removes (but does not return) the customer at the front of this line.
+template <class Growth>
+void EventLine<Growth>::dequeue() {
+    if (isEmpty())
+        throw EmptyDataCollectionException("The Queue is empty.");
+    dequeueUnchecked();
+}
+
+// Description: Returns (but does not remove) the customer at the front of this line,
+//              without checking that there is one.
+template <class Growth>
+Event &EventLine<Growth>::peekUnchecked() const {
+    front.key = Event::makeKey(Event::ARRIVAL, times[frontindex]);
+    front.length = lengths[frontindex];
+    front.teller = 0;
+    return front;
+}
+
+// Description: Returns (but does not remove) the customer at the front of this line.
+template <class Growth>
+Event &EventLine<Growth>::peek() const {
+    if (isEmpty())
+        throw EmptyDataCollectionException("The Queue is empty.");
+    return peekUnchecked();
+}
+
+// Description: If this line is not empty, moves its front element into front,
+//              removes it and returns true; otherwise returns false.
+template <class Growth>
+bool EventLine<Growth>::tryDequeue(Event &front) {
+    if (isEmpty())
+        return false;
+    front = std::move(peekUnchecked());
+    dequeueUnchecked();
+    return true;
+}
+
+// Description: Makes room for at least newCapacity customers and keeps at least that much room.
+template <class Growth>
+void EventLine<Growth>::reserve(unsigned int newCapacity) {
+    if (newCapacity > minimumCapacity)
+        minimumCapacity = newCapacity;
+    if (newCapacity > capacity)
+        resize(newCapacity);
+}
+
+// Description: Returns the number of customers the line holds without reallocating.
+template <class Growth>
+unsigned int EventLine<Growth>::getCapacity() const {
+    return capacity;
+}
+
+// Description: Returns the number of times the arrays were reallocated (grown or shrunk).
+template <class Growth>
+unsigned long long EventLine<Growth>::getReallocationCount() const {
+    return reallocationCount;
+}
@@ -0,0 +1,102 @@
+/*
+ * EventLine.h
+ *
+ * Description: FIFO Queue of arrival events stored as a structure of arrays,
+ *              a drop-in alternative to Queue<Event> for the bank line.
+ *              A customer waiting in line only needs the time they arrived and
+ *              the length of their transaction, so the line keeps two int arrays
+ *              and nothing else: 8 bytes per customer instead of a 16 byte Event,
+ *              which halves the memory very long lines stream through.
+ *
+ * Class Invariant: FIFO order
+ *                  Only arrival events: the type and teller are not kept.
+ */
+
+#ifndef EVENT_LINE_H
+#define EVENT_LINE_H
+
+#include "Event.h"
+#include "GrowthPolicy.h"
+#include "EmptyDataCollectionException.h"
+
+template <class Growth = DefaultGrowth>
+class EventLine {
+
+    private:
+        static unsigned int const INITIAL_CAPACITY = 6; // Constant INITIAL_CAPACITY
+
+        int *times;                               // Arrival time of each customer
+        int *lengths;                             // Transaction length of each customer
+        mutable Event front;                      // The front customer, put back together by peek()
+
+        unsigned int elementCount = 0;            // Number of customers in the line
+        unsigned int capacity = INITIAL_CAPACITY; // Number of cells in each array
+        unsigned int frontindex = 0;              // Index of front customer (next dequeued/peeked)
+        unsigned int backindex = 0;               // Index of where the next customer will be enqueued
+        unsigned int minimumCapacity = INITIAL_CAPACITY; // The arrays never shrink below this (see reserve())
+        unsigned long long reallocationCount = 0; // Number of times the arrays were reallocated
+
+        void resize(unsigned int newCapacity); // To resize the arrays
+
+    public:
+        // Description: Constructor
+        EventLine();
+
+        // Description: Destructor
+        ~EventLine();
+
+        EventLine(const EventLine &) = delete;
+        EventLine & operator=(const EventLine &) = delete;
+
+        // Description: Returns true if this line is empty, otherwise false.
+        // Time Efficiency: O(1)
+        bool isEmpty() const;
+
+        // Description: Inserts newElement at the back of this line
+        //              and returns true if successful, otherwise false.
+        // Precondition: newElement is an arrival event.
+        // Time Efficiency: O(1)
+        bool enqueue(const Event &newElement);
+
+        // Description: Removes (but does not return) the customer at the front of this line.
+        // Precondition: This line is not empty.
+        // Exception: Throws EmptyDataCollectionException if this line is empty.
+        // Time Efficiency: O(1)
+        void dequeue();
+
+        // Description: Returns (but does not remove) the customer at the front of this line.
+        //              The reference stays valid until the next call on the line.
+        // Precondition: This line is not empty.
+        // Exception: Throws EmptyDataCollectionException if this line is empty.
+        // Time Efficiency: O(1)
+        Event &peek() const;
+
+        // Description: Same as dequeue() and peek(), but without checking that this line
+        //              is not empty, for callers that have already checked it (the event loop).
+        // Precondition: This line is not empty. Otherwise the behaviour is undefined.
+        // Time Efficiency: O(1)
+        void dequeueUnchecked();
+        Event &peekUnchecked() const;
+
+        // Description: If this line is not empty, moves its front element into front,
+        //              removes it and returns true; otherwise returns false.
+        //              Never throws EmptyDataCollectionException.
+        // Time Efficiency: O(1)
+        bool tryDequeue(Event &front);
+
+        // Description: Makes room for at least newCapacity customers, so the line can
+        //              grow to that many without reallocating, and keeps at least that
+        //              much room from then on.
+        // Time Efficiency: O(n) if the arrays are reallocated, otherwise O(1)
+        void reserve(unsigned int newCapacity);
+
+        // Description: Returns the number of customers the line holds without reallocating.
+        // Time Efficiency: O(1)
+        unsigned int getCapacity() const;
+
+        // Description: Returns the number of times the arrays were reallocated (grown or shrunk).
+        // Time Efficiency: O(1)
+        unsigned long long getReallocationCount() const;
+};
+#include "EventLine.cpp"
+#endif
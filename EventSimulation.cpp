@@ -0,0 +1,239 @@
+/*
+ * EventSimulation.cpp
+ *
+ * Description: The event loop of Simulation, for one kind of event queue:
+ *              HeapType is the heap behind the PriorityQueue of events
+ *              (BinaryHeap, DaryHeap, CalendarQueue or EventHeap) and LineType
+ *              the FIFO queue of a bank line (Queue or EventLine).
+ *
+ * Class Invariant: The event queue holds at most the next pending arrival plus
+ *                  one departure per busy teller.
+ */
+
+#include <new>
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "EventSimulation.h"
+#include "Instrumentation.h"
+
+
+// Description: Constructor
+template <class HeapType, class LineType>
+EventSimulation<HeapType, LineType>::EventSimulation(unsigned int numberOfTellers, LineDiscipline aDiscipline)
+    : Simulation(numberOfTellers, aDiscipline) {
+    bankLines = static_cast<LineType *>(::operator new(numberOfLines * sizeof(LineType)));
+    for (unsigned int i = 0; i < numberOfLines; i++)
+        new (&bankLines[i]) LineType();
+}
+
+// Description: Constructor, the event queue and the lines take their memory from anAllocator.
+template <class HeapType, class LineType>
+template <class Allocator>
+EventSimulation<HeapType, LineType>::EventSimulation(unsigned int numberOfTellers, LineDiscipline aDiscipline,
+                                                     const Allocator &anAllocator)
+    : Simulation(numberOfTellers, aDiscipline), eventPriorityQueue(anAllocator) {
+    bankLines = static_cast<LineType *>(::operator new(numberOfLines * sizeof(LineType)));
+    for (unsigned int i = 0; i < numberOfLines; i++)
+        new (&bankLines[i]) LineType(anAllocator);
+}
+
+// Description: Destructor
+template <class HeapType, class LineType>
+EventSimulation<HeapType, LineType>::~EventSimulation() {
+    for (unsigned int i = 0; i < numberOfLines; i++)
+        bankLines[i].~LineType();
+    ::operator delete(bankLines);
+}
+
+// Description: Returns the line the customers of teller wait in.
+template <class HeapType, class LineType>
+LineType & EventSimulation<HeapType, LineType>::lineOf(unsigned int teller) {
+    return bankLines[lineIndexOf(teller)];
+}
+
+// Description: Customer begins their transaction with teller at currentTime.
+template <class HeapType, class LineType>
+void EventSimulation<HeapType, LineType>::startService(Event &customer, unsigned int teller) {
+    int departureTime = currentTime + customer.getLength();
+    eventPriorityQueue.emplace(Event::DEPARTURE, departureTime, 0, teller);
+}
+
+// Processes an arrival event
+template <class HeapType, class LineType>
+void EventSimulation<HeapType, LineType>::processArrival(Event &arrivalEvent) {
+    traceLog->arrival(currentTime);
+    if (intervals != nullptr)
+        intervals->arrival();
+
+    // Shared line: any idle teller, or the line. Own lines: the shortest line.
+    unsigned int teller = tellers.leastLoaded();
+    if (tellers.getLoad(teller) == 0) {
+        statistics.recordWait(0);
+        statistics.tellerBusy();
+        if (intervals != nullptr)
+            intervals->recordWait(0);
+        startService(arrivalEvent, teller);
+        tellers.addCustomer(teller);
+    }
+    else {
+        lineOf(teller).enqueue(std::move(arrivalEvent));
+        statistics.joinLine();
+        if (intervals != nullptr)
+            intervals->joinLine();
+        if (discipline == SHORTEST_LINE)
+            tellers.addCustomer(teller);
+    }
+}
+
+// Processes a departure event
+template <class HeapType, class LineType>
+void EventSimulation<HeapType, LineType>::processDeparture(Event &departureEvent) {
+    traceLog->departure(currentTime);
+    if (intervals != nullptr)
+        intervals->departure();
+
+    unsigned int teller = departureEvent.getTeller();
+    LineType &bankLine = lineOf(teller);
+
+    // Customer at front of line begins transaction
+    Event customer;
+    if (bankLine.tryDequeue(customer)) {
+        statistics.leaveLine();
+        statistics.recordWait(currentTime - customer.getTime());
+        if (intervals != nullptr) {
+            intervals->leaveLine();
+            intervals->recordWait(currentTime - customer.getTime());
+        }
+        startService(customer, teller);
+        if (discipline == SHORTEST_LINE)
+            tellers.removeCustomer(teller);
+    } else {
+        tellers.removeCustomer(teller);
+        statistics.tellerIdle();
+    }
+}
+
+// Processes newEvent at its time: the clock, then the arrival or departure
+template <class HeapType, class LineType>
+void EventSimulation<HeapType, LineType>::processEvent(Event &newEvent) {
+    // Get current time
+    currentTime = newEvent.getTime();
+    statistics.advanceTo(currentTime);
+    if (intervals != nullptr)
+        intervals->advanceTo(currentTime);
+
+    if (newEvent.getType() == Event::ARRIVAL) {
+        // Call the Arrival process function
+        processArrival(newEvent);
+        customerCount++;
+    }
+    else {
+        // Call the Departure process function
+        processDeparture(newEvent);
+    }
+}
+
+// Writes the pending events, then every line, to aCheckpoint
+//     Each is drained into a list and refilled in the same order; the event queue
+//     holds at most one event per teller plus an arrival, and the lines keep their
+//     order. Run from a forked child, the parent does not pay for it.
+template <class HeapType, class LineType>
+void EventSimulation<HeapType, LineType>::saveEngine(CheckpointWriter &aCheckpoint) {
+    aCheckpoint.putUInt8(Checkpoint::EVENT_ENGINE);
+
+    std::vector<Event> events;
+    Event anEvent;
+    while (eventPriorityQueue.tryDequeue(anEvent))
+        events.push_back(anEvent);
+    aCheckpoint.putEvents(events);
+    for (unsigned int i = 0; i < events.size(); i++)
+        eventPriorityQueue.enqueue(events[i]);
+
+    for (unsigned int line = 0; line < numberOfLines; line++) {
+        events.clear();
+        while (bankLines[line].tryDequeue(anEvent))
+            events.push_back(anEvent);
+        aCheckpoint.putEvents(events);
+        for (unsigned int i = 0; i < events.size(); i++)
+            bankLines[line].enqueue(events[i]);
+    }
+}
+
+// Reads the pending events and every line back from aCheckpoint
+template <class HeapType, class LineType>
+void EventSimulation<HeapType, LineType>::restoreEngine(CheckpointReader &aCheckpoint) {
+    if (aCheckpoint.getUInt8() != Checkpoint::EVENT_ENGINE)
+        throw std::runtime_error("checkpoint " + aCheckpoint.getFileName() + " is for the single teller engine (see --engine)");
+
+    std::vector<Event> events = aCheckpoint.getEvents();
+    for (unsigned int i = 0; i < events.size(); i++)
+        eventPriorityQueue.enqueue(events[i]);
+    for (unsigned int line = 0; line < numberOfLines; line++) {
+        events = aCheckpoint.getEvents();
+        for (unsigned int i = 0; i < events.size(); i++)
+            bankLines[line].enqueue(events[i]);
+    }
+}
+
+// Description: Runs the simulation over all arrivals, logging events to aTraceLog.
+template <class HeapType, class LineType>
+void EventSimulation<HeapType, LineType>::run(ArrivalReader &arrivals, TraceLog &aTraceLog) {
+    BSIM_PHASE(RUN);
+    traceLog = &aTraceLog;
+
+    Event newArrivalEvent;             // Arrival Event
+
+    // Arrivals are streamed: only the next pending arrival is kept in the event queue
+    if (readArrival(arrivals, newArrivalEvent))
+        eventPriorityQueue.enqueue(std::move(newArrivalEvent));
+
+    // Event Loop: each event is taken off the event queue before it is processed
+    Event newEvent;
+    while (eventPriorityQueue.tryDequeue(newEvent)) {
+        bool arriving = newEvent.getType() == Event::ARRIVAL;
+        processEvent(newEvent);
+
+        if (arriving) {
+            // A checkpoint has no pending arrival: it is taken before the next is read
+            if (checkpoints != nullptr && checkpointIfDue())
+                break;
+
+            // Add the next arrival event to the event queue
+            if (readArrival(arrivals, newArrivalEvent))
+                eventPriorityQueue.enqueue(std::move(newArrivalEvent));
+        }
+    }
+    if (intervals != nullptr && !isStopped())
+        intervals->finish();
+    traceLog->flush();
+}
+
+// Returns in time the time of the first event of a run driven by the caller
+//     As in run(), the next arrival given waits in the event queue, so the
+//     departures come off the same heap in the same order.
+template <class HeapType, class LineType>
+bool EventSimulation<HeapType, LineType>::peekEvent(int &time, bool &arriving) {
+    if (!arrivalQueued && !pushedArrivals.isEmpty()) {
+        eventPriorityQueue.enqueue(pushedArrivals.peekUnchecked());
+        pushedArrivals.dequeueUnchecked();
+        arrivalQueued = true;
+    }
+    if (eventPriorityQueue.isEmpty())
+        return false;
+    const Event &nextEvent = eventPriorityQueue.peekUnchecked();
+    time = nextEvent.getTime();
+    arriving = nextEvent.getType() == Event::ARRIVAL;
+    return true;
+}
+
+// Processes the first event of a run driven by the caller
+template <class HeapType, class LineType>
+void EventSimulation<HeapType, LineType>::processNextEvent() {
+    Event newEvent;
+    eventPriorityQueue.tryDequeue(newEvent);
+    if (newEvent.getType() == Event::ARRIVAL)
+        arrivalQueued = false;
+    processEvent(newEvent);
+}
@@ -0,0 +1,71 @@
+/*
+ * EventSimulation.h
+ *
+ * Description: The event loop of Simulation, for one kind of event queue:
+ *              HeapType is the heap behind the PriorityQueue of events
+ *              (BinaryHeap, DaryHeap, CalendarQueue or EventHeap) and LineType
+ *              the FIFO queue of a bank line (Queue or EventLine).
+ *
+ * Class Invariant: The event queue holds at most the next pending arrival plus
+ *                  one departure per busy teller.
+ */
+
+#ifndef EVENT_SIMULATION_H
+#define EVENT_SIMULATION_H
+
+#include "Event.h"
+#include "PriorityQueue.h"
+#include "Simulation.h"
+
+template <class HeapType, class LineType = Simulation::BankLine>
+class EventSimulation : public Simulation {
+
+    private:
+        PriorityQueue<Event, HeapType> eventPriorityQueue;   // Event Queue
+        LineType *bankLines;                                 // Bank Line(s): one shared, or one per teller
+        bool arrivalQueued = false;                          // Run driven by the caller: the event queue holds an arrival
+
+        // Description: Returns the line the customers of teller wait in.
+        LineType &lineOf(unsigned int teller);
+
+        // Description: Customer begins their transaction with teller at currentTime.
+        void startService(Event &customer, unsigned int teller);
+
+        // Processes an arrival event
+        void processArrival(Event &arrivalEvent);
+
+        // Processes a departure event
+        void processDeparture(Event &departureEvent);
+
+        // Processes newEvent at its time: the clock, then the arrival or departure
+        void processEvent(Event &newEvent);
+
+        // Writes the pending events, then every line, to aCheckpoint, and reads them back
+        void saveEngine(CheckpointWriter &aCheckpoint);
+        void restoreEngine(CheckpointReader &aCheckpoint);
+
+        // Steps of a run driven by the caller
+        bool peekEvent(int &time, bool &arriving);
+        void processNextEvent();
+
+    public:
+        // Description: Constructor
+        EventSimulation(unsigned int numberOfTellers, LineDiscipline aDiscipline);
+
+        // Description: Constructor, the event queue and the lines take their memory from anAllocator.
+        // Precondition: HeapType and LineType can be constructed from an Allocator.
+        template <class Allocator>
+        EventSimulation(unsigned int numberOfTellers, LineDiscipline aDiscipline, const Allocator &anAllocator);
+
+        // Description: Destructor
+        ~EventSimulation();
+
+        // Description: Runs the simulation over all arrivals, logging events to aTraceLog.
+        // Precondition: arrivals are sorted by time.
+        // Exceptions: Throws runtime_error if the arrivals are not sorted by time,
+        //             or the interval metrics cannot be written,
+        //             and whatever arrivals throws when it cannot be read.
+        void run(ArrivalReader &arrivals, TraceLog &aTraceLog);
+};
+#include "EventSimulation.cpp"
+#endif
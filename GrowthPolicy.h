@@ -0,0 +1,37 @@
+/*
+ * GrowthPolicy.h
+ *
+ * Description: When Queue and BinaryHeap reallocate their arrays.
+ *              grow() is the capacity to move to when the array is full.
+ *              shrink() is the capacity to move to after a removal, or the
+ *              current capacity to keep the array as it is: the array halves once
+ *              fewer than 1/ShrinkDivisor of its cells are in use, and never goes
+ *              below minimumCapacity (the initial or reserved capacity).
+ *              The larger ShrinkDivisor, the wider the band of sizes a container
+ *              can move through without reallocating; 0 never shrinks.
+ */
+
+#ifndef GROWTH_POLICY_H
+#define GROWTH_POLICY_H
+
+template <unsigned int GrowthFactor = 2, unsigned int ShrinkDivisor = 4>
+struct GrowthPolicy {
+
+    static_assert(GrowthFactor >= 2, "the array must at least double when it grows");
+    static_assert(ShrinkDivisor == 0 || ShrinkDivisor > 2, "a halved array must not be full");
+
+    static unsigned int grow(unsigned int capacity) {
+        return capacity * GrowthFactor;
+    }
+
+    static unsigned int shrink(unsigned int capacity, unsigned int elementCount, unsigned int minimumCapacity) {
+        if (ShrinkDivisor == 0 || elementCount >= capacity / ShrinkDivisor || capacity / 2 < minimumCapacity)
+            return capacity;
+        return capacity / 2;
+    }
+};
+
+typedef GrowthPolicy<2, 4> DefaultGrowth;   // Doubles when full, halves below 1/4 full
+typedef GrowthPolicy<2, 8> LazyShrink;      // Doubles when full, halves below 1/8 full
+typedef GrowthPolicy<2, 0> NeverShrink;     // Doubles when full, keeps its peak capacity
+#endif
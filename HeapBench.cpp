@@ -0,0 +1,347 @@
+/*
+ * HeapBench.cpp
+ *
+ * Description: Microbenchmark of the event queue heap: insert and remove
+ *              throughput of BinaryHeap<Event> and the 4-ary DaryHeap<Event>
+ *              against the recursive, swap-based heap BinaryHeap replaced,
+ *              at several heap sizes. Then the event mix of the simulation:
+ *              a queue holding a steady number of pending events, where each
+ *              step pops the next event and schedules an arrival or departure,
+ *              also run on the CalendarQueue and the structure-of-arrays EventHeap,
+ *              and once more through the checked API (peek, dequeue, inside a try
+ *              block) against the unchecked one (tryDequeue) the event loop uses.
+ *              Last, a bank line whose length swings between a quarter and all of
+ *              the size, under the default and the lazy shrink growth policies,
+ *              counting reallocations, and as a structure-of-arrays EventLine.
+ *              The large sizes do not fit in the cache, so they show how much
+ *              memory traffic each layout costs. Finally, many short runs that
+ *              each build and tear down an event heap and a bank line, with the
+ *              arrays from the system allocator or from a MonotonicArena reset
+ *              between runs, as in a parameter sweep.
+ *
+ *              Usage: heapbench [size ...]   (default: 1000 1000000 100000000)
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Event.h"
+#include "BinaryHeap.h"
+#include "DaryHeap.h"
+#include "CalendarQueue.h"
+#include "PriorityQueue.h"
+#include "Queue.h"
+#include "EventHeap.h"
+#include "EmptyDataCollectionException.h"
+#include "EventLine.h"
+#include "GrowthPolicy.h"
+#include "MonotonicArena.h"
+
+using namespace std;
+
+
+// The previous BinaryHeap algorithm, kept for comparison: recursive reHeapUp and
+// reHeapDown that swap elements (three copies per level) and compare with operator<=.
+template <class ElementType>
+class RecursiveBinaryHeap {
+
+    private:
+        static unsigned int const INITIAL_CAPACITY = 6;
+        ElementType *elements;
+        unsigned int elementCount = 0;
+        unsigned int capacity = INITIAL_CAPACITY;
+
+        void reHeapUp(unsigned int indexOfBottom) {
+            if (indexOfBottom > 0) {
+                unsigned int indexOfParent = floor((indexOfBottom-1)/2);
+                if (elements[indexOfBottom] <= elements[indexOfParent]) {
+                    ElementType temp = elements[indexOfBottom];
+                    elements[indexOfBottom] = elements[indexOfParent];
+                    elements[indexOfParent] = temp;
+                    reHeapUp(indexOfParent);
+                }
+            }
+        }
+
+        void reHeapDown(unsigned int indexOfRoot) {
+            unsigned int indexOfMinChild = indexOfRoot;
+            unsigned int indexOfLeftChild = 2 * indexOfRoot + 1;
+            unsigned int indexOfRightChild = 2 * indexOfRoot + 2;
+            if (indexOfLeftChild > elementCount - 1) return;
+            if ( ! (elements[indexOfRoot] <= elements[indexOfLeftChild]) )
+                indexOfMinChild = indexOfLeftChild;
+            if (indexOfRightChild < elementCount) {
+                if ( ! (elements[indexOfMinChild] <= elements[indexOfRightChild]) )
+                    indexOfMinChild = indexOfRightChild;
+            }
+            if (indexOfMinChild != indexOfRoot) {
+                ElementType temp = elements[indexOfRoot];
+                elements[indexOfRoot] = elements[indexOfMinChild];
+                elements[indexOfMinChild] = temp;
+                reHeapDown(indexOfMinChild);
+            }
+        }
+
+        void resize(unsigned int newCapacity) {
+            ElementType * newElements = new ElementType[newCapacity];
+            for (unsigned int i = 0; i < elementCount; i++)
+                newElements[i] = elements[i];
+            delete[] elements;
+            elements = newElements;
+            capacity = newCapacity;
+        }
+
+    public:
+        RecursiveBinaryHeap() { elements = new ElementType[INITIAL_CAPACITY]; }
+        ~RecursiveBinaryHeap() { delete[] elements; }
+
+        unsigned int getElementCount() const { return elementCount; }
+
+        ElementType &retrieve() const { return elements[0]; }
+
+        bool insert(ElementType &newElement) {
+            if (elementCount == capacity)
+                resize(capacity*2);
+            elements[elementCount] = newElement;
+            elementCount++;
+            if (elementCount > 1)
+                reHeapUp(elementCount - 1);
+            return true;
+        }
+
+        void remove() {
+            elements[0] = elements[elementCount - 1];
+            elementCount--;
+            if ( elementCount > 0 )
+                reHeapDown(0);
+            if (elementCount < (capacity/4) && ((capacity/2) >= INITIAL_CAPACITY))
+                resize(capacity/2);
+        }
+};
+
+
+// Inserts every event into an empty heap, then removes them all.
+// Prints the throughput of each phase in millions of operations per second.
+template <class HeapType>
+void benchmark(const char *name, const vector<Event> &events) {
+    HeapType heap;
+    long long checksum = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < events.size(); i++) {
+        Event newEvent = events[i];
+        heap.insert(newEvent);
+    }
+    chrono::duration<double> insertTime = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    while (heap.getElementCount() > 0) {
+        checksum += heap.retrieve().getTime();
+        heap.remove();
+    }
+    chrono::duration<double> removeTime = chrono::steady_clock::now() - start;
+
+    double millions = events.size() / 1e6;
+    cout << setw(12) << events.size() << "  " << setw(10) << name
+         << "  insert " << setw(8) << millions / insertTime.count() << " M/s"
+         << "  remove " << setw(8) << millions / removeTime.count() << " M/s"
+         << "  (checksum " << checksum << ")" << endl;
+}
+
+// Keeps pending events queued and times pop + schedule steps, like the event loop:
+// every popped event schedules a later arrival or departure.
+template <class HeapType>
+void holdBenchmark(const char *name, const vector<Event> &events) {
+    PriorityQueue<Event, HeapType> eventPriorityQueue;
+    for (size_t i = 0; i < events.size(); i++) {
+        Event newEvent = events[i];
+        eventPriorityQueue.enqueue(newEvent);
+    }
+
+    mt19937 generator(1);
+    size_t steps = max(events.size(), (size_t)1000000);
+    long long checksum = 0;
+    unsigned long long reallocations = eventPriorityQueue.getReallocationCount();
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < steps; i++) {
+        Event nextEvent = eventPriorityQueue.peek();
+        eventPriorityQueue.dequeue();
+        checksum += nextEvent.getTime();
+
+        unsigned int random = generator();
+        Event newEvent((random & 1) ? Event::ARRIVAL : Event::DEPARTURE, nextEvent.getTime() + (int)(random >> 1) % 1024);
+        eventPriorityQueue.enqueue(newEvent);
+    }
+    chrono::duration<double> holdTime = chrono::steady_clock::now() - start;
+
+    cout << setw(12) << events.size() << "  " << setw(10) << name
+         << "  event mix " << setw(8) << steps / 1e6 / holdTime.count() << " M steps/s"
+         << "  reallocations " << eventPriorityQueue.getReallocationCount() - reallocations
+         << "  (checksum " << checksum << ")" << endl;
+}
+
+// The event mix of holdBenchmark, taking each event off the queue the way the event loop
+// used to (isEmpty, peek and dequeue, inside a try block) and the way it does now (tryDequeue).
+template <class HeapType>
+void uncheckedBenchmark(const char *name, const vector<Event> &events) {
+    size_t steps = max(events.size(), (size_t)1000000);
+    double time[2];
+    long long checksum[2] = { 0, 0 };
+
+    for (int unchecked = 0; unchecked < 2; unchecked++) {
+        PriorityQueue<Event, HeapType> eventPriorityQueue;
+        for (size_t i = 0; i < events.size(); i++) {
+            Event newEvent = events[i];
+            eventPriorityQueue.enqueue(newEvent);
+        }
+        mt19937 generator(1);
+
+        auto start = chrono::steady_clock::now();
+        Event nextEvent;
+        for (size_t i = 0; i < steps; i++) {
+            if (unchecked) {
+                if (!eventPriorityQueue.tryDequeue(nextEvent))
+                    break;
+            }
+            else {
+                if (eventPriorityQueue.isEmpty())
+                    break;
+                try {
+                    nextEvent = eventPriorityQueue.peek();
+                    eventPriorityQueue.dequeue();
+                }
+                catch (EmptyDataCollectionException &anException) {
+                    break;
+                }
+            }
+            checksum[unchecked] += nextEvent.getTime();
+
+            unsigned int random = generator();
+            Event newEvent((random & 1) ? Event::ARRIVAL : Event::DEPARTURE, nextEvent.getTime() + (int)(random >> 1) % 1024);
+            eventPriorityQueue.enqueue(newEvent);
+        }
+        time[unchecked] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    cout << setw(12) << events.size() << "  " << setw(10) << name
+         << "  checked " << setw(8) << steps / 1e6 / time[0] << " M steps/s"
+         << "  unchecked " << setw(8) << steps / 1e6 / time[1] << " M steps/s"
+         << "  (checksums " << (checksum[0] == checksum[1] ? "match" : "differ") << ")" << endl;
+}
+
+// Fills a bank line to size customers and drains it to just under a quarter, over and over,
+// like a line that builds up at peak hours. Counts the reallocations after the first fill.
+template <class LineType>
+void lineBenchmark(const char *name, const vector<Event> &events) {
+    LineType bankLine;
+    size_t size = events.size();
+    size_t low = size / 4 > 0 ? size / 4 - 1 : 0;
+    size_t cycles = max((size_t)1, (size_t)10000000 / (size + 1));
+    long long checksum = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        Event customer = events[i];
+        bankLine.enqueue(customer);
+    }
+    unsigned long long reallocations = bankLine.getReallocationCount();
+
+    auto start = chrono::steady_clock::now();
+    for (size_t cycle = 0; cycle < cycles; cycle++) {
+        for (size_t i = low; i < size; i++) {
+            checksum += bankLine.peek().getTime();
+            bankLine.dequeue();
+        }
+        for (size_t i = low; i < size; i++) {
+            Event customer = events[i];
+            bankLine.enqueue(customer);
+        }
+    }
+    chrono::duration<double> lineTime = chrono::steady_clock::now() - start;
+
+    cout << setw(12) << size << "  " << setw(10) << name
+         << "  bank line " << setw(8) << 2.0 * cycles * (size - low) / 1e6 / lineTime.count() << " M ops/s"
+         << "  reallocations " << bankLine.getReallocationCount() - reallocations
+         << "  (checksum " << checksum << ")" << endl;
+}
+
+// Builds an event heap and a bank line of size events and empties them again, many times,
+// like the runs of a parameter sweep. With an arena, every run takes its arrays from it
+// and resets it at the end; without one, they come from operator new.
+template <class Growth>
+void runsBenchmark(const char *name, const vector<Event> &events, MonotonicArena *arena) {
+    typedef ArenaAllocator<Event> Allocator;
+    size_t size = min(events.size(), (size_t)100000);
+    size_t runs = max((size_t)1, (size_t)10000000 / (size + 1));
+    long long checksum = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (size_t run = 0; run < runs; run++) {
+        {
+            BinaryHeap<Event, HeapOrder<Event>, Growth, Allocator> eventHeap{Allocator(arena)};
+            Queue<Event, Growth, Allocator> bankLine{Allocator(arena)};
+            for (size_t i = 0; i < size; i++) {
+                Event newEvent = events[i];
+                eventHeap.insert(newEvent);
+                bankLine.enqueue(newEvent);
+            }
+            while (eventHeap.getElementCount() > 0) {
+                checksum += eventHeap.retrieve().getTime() - bankLine.peek().getTime();
+                eventHeap.remove();
+                bankLine.dequeue();
+            }
+        }
+        if (arena != nullptr)
+            arena->reset();
+    }
+    chrono::duration<double> runsTime = chrono::steady_clock::now() - start;
+
+    cout << setw(12) << size << "  " << setw(10) << name
+         << "  runs " << setw(8) << runs / runsTime.count() << " runs/s";
+    if (arena != nullptr)
+        cout << "  peak " << arena->getPeakUsage() / 1024 << " KiB in " << arena->getCapacity() / 1024
+             << " KiB block, " << arena->getOverflowCount() << " overflows";
+    cout << "  (checksum " << checksum << ")" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    vector<unsigned long> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(strtoul(argv[i], nullptr, 10));
+    if (sizes.empty())
+        sizes = { 1000, 1000000, 100000000 };
+
+    cout << setprecision(4);
+    for (size_t s = 0; s < sizes.size(); s++) {
+        // Random arrivals and departures over a time range a few times the size, so times repeat
+        mt19937 generator(sizes[s]);
+        uniform_int_distribution<int> time(0, (int)min(sizes[s] * 4, 2000000000UL));
+        vector<Event> events;
+        events.reserve(sizes[s]);
+        for (size_t i = 0; i < sizes[s]; i++)
+            events.push_back(Event(generator() % 2 ? Event::ARRIVAL : Event::DEPARTURE, time(generator)));
+
+        benchmark<RecursiveBinaryHeap<Event>>("recursive", events);
+        benchmark<BinaryHeap<Event>>("hole", events);
+        benchmark<QuaternaryHeap<Event>>("4-ary", events);
+        benchmark<EventHeap<>>("soa", events);
+        holdBenchmark<BinaryHeap<Event>>("binary", events);
+        holdBenchmark<QuaternaryHeap<Event>>("4-ary", events);
+        holdBenchmark<CalendarQueue<Event>>("calendar", events);
+        holdBenchmark<EventHeap<>>("soa", events);
+        uncheckedBenchmark<BinaryHeap<Event>>("binary", events);
+        uncheckedBenchmark<EventHeap<>>("soa", events);
+        lineBenchmark<Queue<Event, DefaultGrowth>>("default", events);
+        lineBenchmark<Queue<Event, LazyShrink>>("lazy", events);
+        lineBenchmark<EventLine<LazyShrink>>("soa lazy", events);
+
+        MonotonicArena arena(64 * 1024);
+        runsBenchmark<DefaultGrowth>("new", events, nullptr);
+        runsBenchmark<NeverShrink>("arena", events, &arena);
+    }
+    return 0;
+}
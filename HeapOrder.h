@@ -0,0 +1,18 @@
+/*
+ * HeapOrder.h
+ *
+ * Description: Default comparator of the heaps: lhs comes out of the heap
+ *              no later than rhs when lhs <= rhs. Element types can provide
+ *              a faster ordering by specializing HeapOrder (see Event.h).
+ */
+
+#ifndef HEAP_ORDER_H
+#define HEAP_ORDER_H
+
+template <class ElementType>
+struct HeapOrder {
+    bool operator()(const ElementType &lhs, const ElementType &rhs) const {
+        return lhs <= rhs;
+    }
+};
+#endif
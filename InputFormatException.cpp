@@ -0,0 +1,15 @@
+/*
+ * InputFormatException.cpp
+ *
+ * Class Description: Defines the exception that is thrown when a line of the
+ *                    input is not a valid "time length" pair.
+ */
+ 
+#include "InputFormatException.h"  
+#include "Instrumentation.h"
+
+// Constructor
+InputFormatException::InputFormatException(unsigned long long lineNumber, const string& message): 
+runtime_error("InputFormatException: line " + std::to_string(lineNumber) + ": " + message) {
+    BSIM_COUNT(EXCEPTIONS_THROWN);
+}
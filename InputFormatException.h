@@ -0,0 +1,24 @@
+/*
+ * InputFormatException.h
+ *
+ * Class Description: Defines the exception that is thrown when a line of the
+ *                    input is not a valid "time length" pair.
+ */
+ 
+#ifndef INPUT_FORMAT_EXCEPTION_H
+#define INPUT_FORMAT_EXCEPTION_H
+
+#include <stdexcept>
+#include <string>
+
+using std::string;
+using std::runtime_error;
+
+class InputFormatException : public runtime_error {
+ 
+   public:
+      // Constructor
+      InputFormatException(unsigned long long lineNumber, const string& message = "");
+   
+}; 
+#endif
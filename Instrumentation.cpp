@@ -0,0 +1,86 @@
+/*
+ * Instrumentation.cpp
+ *
+ * Description: Optional counters and phase timers for finding where a run spends
+ *              its time (see Instrumentation.h).
+ *
+ * Class Invariant: A phase timer adds the cycles from its construction to its
+ *                  destruction to its phase.
+ */
+
+#include "Instrumentation.h"
+
+using std::endl;
+
+namespace Instrumentation {
+
+#ifdef BSIM_INSTRUMENT
+thread_local unsigned long long counters[NUMBER_OF_COUNTERS] = {};
+thread_local uint64_t phaseCycles[NUMBER_OF_PHASES] = {};
+#endif
+
+// Description: Returns true if the instrumentation is compiled in.
+bool isEnabled() {
+#ifdef BSIM_INSTRUMENT
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Description: Returns the count of counter in this thread.
+#ifdef BSIM_INSTRUMENT
+unsigned long long count(Counter counter) {
+    return counters[counter];
+}
+#else
+unsigned long long count(Counter) {
+    return 0;
+}
+#endif
+
+// Description: Returns the cycles spent in phase by this thread.
+#ifdef BSIM_INSTRUMENT
+uint64_t cycles(Phase phase) {
+    return phaseCycles[phase];
+}
+#else
+uint64_t cycles(Phase) {
+    return 0;
+}
+#endif
+
+// Description: Prints the counters and phase timers of this thread.
+//              The event loop is split into parsing, logging and the rest (the events
+//              themselves); sift levels are also given per heap operation.
+void print(std::ostream &output) {
+    if (!isEnabled())
+        return;
+
+    uint64_t run = cycles(RUN);
+    uint64_t parse = cycles(PARSE);
+    uint64_t log = cycles(LOG);
+    uint64_t events = run > parse + log ? run - parse - log : 0;
+    auto share = [run](uint64_t phaseCycles) { return run == 0 ? 0.0 : 100.0 * phaseCycles / run; };
+    unsigned long long heapOperations = count(HEAP_INSERTS) + count(HEAP_REMOVES);
+
+    output << endl;
+    output << "Instrumentation: " << endl;
+    output << endl;
+    output << "    Setup cycles: " << cycles(SETUP) << endl;
+    output << "    Event loop cycles: " << run << endl;
+    output << "        parsing arrivals: " << parse << " (" << share(parse) << "%)" << endl;
+    output << "        logging events: " << log << " (" << share(log) << "%)" << endl;
+    output << "        processing events: " << events << " (" << share(events) << "%)" << endl;
+    output << "    Summary cycles: " << cycles(SUMMARY) << endl;
+    output << "    Heap inserts / removes / resizes: " << count(HEAP_INSERTS) << " / " << count(HEAP_REMOVES)
+           << " / " << count(HEAP_RESIZES) << endl;
+    output << "    Heap levels sifted: " << count(HEAP_SIFT_LEVELS) << " ("
+           << (heapOperations == 0 ? 0.0 : double(count(HEAP_SIFT_LEVELS)) / heapOperations)
+           << " per operation)" << endl;
+    output << "    Queue enqueues / dequeues / resizes: " << count(QUEUE_ENQUEUES) << " / " << count(QUEUE_DEQUEUES)
+           << " / " << count(QUEUE_RESIZES) << endl;
+    output << "    Exceptions thrown: " << count(EXCEPTIONS_THROWN) << endl;
+}
+
+}
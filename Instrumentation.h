@@ -0,0 +1,98 @@
+/*
+ * Instrumentation.h
+ *
+ * Description: Optional counters and phase timers for finding where a run spends
+ *              its time: heap and queue operations (inserts, removes, levels sifted,
+ *              resizes), exceptions thrown, and the cycles spent parsing arrivals,
+ *              in the event loop and writing the log.
+ *
+ *              Compiled in only with -DBSIM_INSTRUMENT (make INSTRUMENT=-DBSIM_INSTRUMENT,
+ *              after make clean). Otherwise every BSIM_COUNT and BSIM_PHASE expands to
+ *              nothing, so the instrumented code is exactly the uninstrumented code.
+ *
+ *              Counters and timers are per thread: the summary covers the thread
+ *              that prints it.
+ *
+ * Class Invariant: A phase timer adds the cycles from its construction to its
+ *                  destruction to its phase.
+ */
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace Instrumentation {
+    enum Counter { HEAP_INSERTS, HEAP_REMOVES, HEAP_SIFT_LEVELS, HEAP_RESIZES,
+                   QUEUE_ENQUEUES, QUEUE_DEQUEUES, QUEUE_RESIZES, EXCEPTIONS_THROWN,
+                   NUMBER_OF_COUNTERS };
+
+    enum Phase { SETUP,           // Opening the input, reading it up front (sweeps, --unsorted)
+                 RUN,             // The whole event loop, including the two below
+                 PARSE,           // Reading the next arrival (within RUN)
+                 LOG,             // Logging events (within RUN)
+                 SUMMARY,         // Printing the final statistics
+                 NUMBER_OF_PHASES };
+
+    // Description: Returns true if the instrumentation is compiled in.
+    bool isEnabled();
+
+    // Description: Returns the count of counter in this thread.
+    unsigned long long count(Counter counter);
+
+    // Description: Returns the cycles spent in phase by this thread.
+    uint64_t cycles(Phase phase);
+
+    // Description: Prints the counters and phase timers of this thread, in the style of
+    //              the final statistics. Prints nothing if the instrumentation is compiled out.
+    void print(std::ostream &output);
+
+#ifdef BSIM_INSTRUMENT
+    extern thread_local unsigned long long counters[NUMBER_OF_COUNTERS];
+    extern thread_local uint64_t phaseCycles[NUMBER_OF_PHASES];
+
+    // Description: Returns the current value of the cycle counter.
+    inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();   // Nanoseconds, not cycles
+#endif
+    }
+
+    // Adds the cycles of its lifetime to a phase.
+    class PhaseTimer {
+
+        private:
+            Phase phase;
+            uint64_t start;
+
+        public:
+            // Description: Constructor, starts timing aPhase.
+            PhaseTimer(Phase aPhase) : phase(aPhase), start(now()) { }
+
+            // Description: Destructor, adds the cycles since construction to the phase.
+            ~PhaseTimer() {
+                phaseCycles[phase] += now() - start;
+            }
+
+            PhaseTimer(const PhaseTimer &) = delete;
+            PhaseTimer & operator=(const PhaseTimer &) = delete;
+    };
+#endif
+}
+
+#ifdef BSIM_INSTRUMENT
+#define BSIM_COUNT(counter) (Instrumentation::counters[Instrumentation::counter]++)
+#define BSIM_COUNT_BY(counter, amount) (Instrumentation::counters[Instrumentation::counter] += (amount))
+#define BSIM_PHASE_NAME(line) bsimPhaseTimer##line
+#define BSIM_PHASE_AT(phase, line) Instrumentation::PhaseTimer BSIM_PHASE_NAME(line)(Instrumentation::phase)
+#define BSIM_PHASE(phase) BSIM_PHASE_AT(phase, __LINE__)          // Times the rest of the enclosing block
+#else
+#define BSIM_COUNT(counter) ((void)0)
+#define BSIM_COUNT_BY(counter, amount) ((void)0)
+#define BSIM_PHASE(phase) ((void)0)
+#endif
+#endif
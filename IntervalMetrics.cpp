@@ -0,0 +1,202 @@
+/*
+ * IntervalMetrics.cpp
+ *
+ * Description: Metrics of a simulation over consecutive time intervals of a fixed
+ *              width, written out to an IntervalSink as each interval ends
+ *              (see IntervalMetrics.h).
+ *
+ * Class Invariant: Intervals are written in time order, one for every interval from
+ *                  the first event to the last, including intervals without events.
+ */
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include "IntervalMetrics.h"
+
+using std::string;
+using std::runtime_error;
+
+
+// Description: Constructor, intervals of aWidth time units go to aSink.
+IntervalMetrics::IntervalMetrics(int64_t aWidth, IntervalSink &aSink) : width(aWidth), sink(aSink) {
+    begin(0);
+}
+
+// Description: Starts an empty interval at start.
+//              The people still waiting in line carry over into it.
+void IntervalMetrics::begin(int64_t start) {
+    current.start = start;
+    current.end = start + width;
+    current.arrivals = 0;
+    current.departures = 0;
+    current.served = 0;
+    current.meanWait = 0;
+    current.maxWait = 0;
+    current.averageLineLength = 0;
+    current.maxLineLength = waiting;
+    totalWait = 0;
+    waitingArea = 0;
+}
+
+// Description: Writes the current interval, which ends at time.
+void IntervalMetrics::end(int64_t time) {
+    current.end = time;
+    if (current.served > 0)
+        current.meanWait = double(totalWait) / current.served;
+    if (time > current.start)
+        current.averageLineLength = waitingArea / (time - current.start);
+    else
+        current.averageLineLength = waiting;
+    sink.write(current, width);
+}
+
+// Description: Moves the clock to time, writing out every interval that ends by then.
+//              The first call aligns the intervals to multiples of the width.
+void IntervalMetrics::advanceTo(int64_t time) {
+    if (!started) {
+        started = true;
+        int64_t offset = ((time % width) + width) % width;   // Also for negative times
+        begin(time - offset);
+        lastTime = time;
+        return;
+    }
+
+    while (time >= current.start + width) {
+        int64_t boundary = current.start + width;
+        waitingArea += double(waiting) * (boundary - lastTime);
+        lastTime = boundary;
+        end(boundary);
+        begin(boundary);
+    }
+    waitingArea += double(waiting) * (time - lastTime);
+    lastTime = time;
+}
+
+// Description: Records an arrival at the current time.
+void IntervalMetrics::arrival() {
+    current.arrivals++;
+}
+
+// Description: Records a departure at the current time.
+void IntervalMetrics::departure() {
+    current.departures++;
+}
+
+// Description: Records the wait of a customer whose service starts now.
+void IntervalMetrics::recordWait(int64_t waitTime) {
+    current.served++;
+    totalWait += waitTime;
+    if (current.served == 1 || waitTime > current.maxWait)
+        current.maxWait = waitTime;
+}
+
+// Description: Records a customer joining a line.
+void IntervalMetrics::joinLine() {
+    waiting++;
+    if (waiting > current.maxLineLength)
+        current.maxLineLength = waiting;
+}
+
+// Description: Records a customer leaving a line.
+void IntervalMetrics::leaveLine() {
+    waiting--;
+}
+
+// Description: Writes out the interval in progress, which ends at the last event.
+void IntervalMetrics::finish() {
+    if (!started)
+        return;
+    end(lastTime);
+    started = false;
+}
+
+
+// Description: Destructor
+IntervalSink::~IntervalSink() { }
+
+
+// Description: Constructor, creates fileName and writes the header line.
+CsvIntervalSink::CsvIntervalSink(const string &fileName) {
+    file = fopen(fileName.c_str(), "w");
+    if (file == nullptr)
+        throw runtime_error("could not create interval file " + fileName);
+    if (fputs("start,end,arrivals,departures,served,mean_wait,max_wait,average_line_length,max_line_length\n",
+              file) == EOF) {
+        fclose(file);
+        throw runtime_error("could not write interval file " + fileName);
+    }
+}
+
+// Description: Destructor, closes the file if close() was not called.
+CsvIntervalSink::~CsvIntervalSink() {
+    if (file != nullptr)
+        fclose(file);
+}
+
+// Description: Writes out one interval as a line of text.
+void CsvIntervalSink::write(const IntervalMetrics::Interval &interval, int64_t) {
+    if (fprintf(file, "%" PRId64 ",%" PRId64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.6g,%" PRId64 ",%.6g,%" PRIu64 "\n",
+                interval.start, interval.end, interval.arrivals, interval.departures, interval.served,
+                interval.meanWait, interval.maxWait, interval.averageLineLength, interval.maxLineLength) < 0)
+        throw runtime_error("could not write interval file");
+}
+
+// Description: Closes the file.
+void CsvIntervalSink::close() {
+    bool written = fclose(file) == 0;
+    file = nullptr;
+    if (!written)
+        throw runtime_error("could not write interval file");
+}
+
+
+char const BinaryIntervalSink::MAGIC[8] = { 'B', 'S', 'I', 'M', 'I', 'N', 'T', '1' };
+
+// Description: Constructor, creates fileName and writes a provisional header.
+BinaryIntervalSink::BinaryIntervalSink(const string &fileName) {
+    file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr)
+        throw runtime_error("could not create interval file " + fileName);
+
+    Header header;
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.recordSize = sizeof(IntervalMetrics::Interval);
+    header.width = 0;
+    header.recordCount = 0;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        throw runtime_error("could not write interval file " + fileName);
+    }
+}
+
+// Description: Destructor, finishes the file if close() was not called.
+BinaryIntervalSink::~BinaryIntervalSink() {
+    if (file != nullptr) {
+        try {
+            close();
+        } catch (runtime_error &) { }
+    }
+}
+
+// Description: Appends one interval record.
+void BinaryIntervalSink::write(const IntervalMetrics::Interval &interval, int64_t aWidth) {
+    if (fwrite(&interval, sizeof(interval), 1, file) != 1)
+        throw runtime_error("could not write interval file");
+    width = aWidth;
+    recordCount++;
+}
+
+// Description: Writes the width and record count into the header and closes the file.
+void BinaryIntervalSink::close() {
+    bool written = fseek(file, offsetof(Header, width), SEEK_SET) == 0
+                   && fwrite(&width, sizeof(width), 1, file) == 1
+                   && fwrite(&recordCount, sizeof(recordCount), 1, file) == 1;
+    written = (fclose(file) == 0) && written;
+    file = nullptr;
+
+    if (!written)
+        throw runtime_error("could not write interval file");
+}
@@ -0,0 +1,177 @@
+/*
+ * IntervalMetrics.h
+ *
+ * Description: Metrics of a simulation over consecutive time intervals of a fixed
+ *              width (say every 900 time units), written out as each interval ends
+ *              rather than summed up at the end of the run.
+ *              Every interval reports its arrivals and departures, the customers
+ *              whose service started with their mean and longest wait, and the time
+ *              average and maximum of the number of people waiting in line.
+ *              Only the interval in progress is kept in memory: a finished interval
+ *              goes straight to its IntervalSink, so a trace of any length runs in
+ *              constant memory.
+ *
+ *              Sinks: CsvIntervalSink (one line of text per interval, with a header
+ *              line) and BinaryIntervalSink (fixed-width records, native byte order):
+ *                  header : magic "BSIMINT1", uint32 version, uint32 record size,
+ *                           int64 width, uint64 record count
+ *                  records: IntervalMetrics::Interval
+ *
+ * Class Invariant: Intervals are written in time order, one for every interval from
+ *                  the first event to the last, including intervals without events.
+ */
+
+#ifndef INTERVAL_METRICS_H
+#define INTERVAL_METRICS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+class IntervalSink;
+
+class IntervalMetrics {
+
+    public:
+        // Metrics of one interval, [start, end)
+        struct Interval {
+            int64_t start;
+            int64_t end;
+            uint64_t arrivals;
+            uint64_t departures;
+            uint64_t served;               // Customers whose service started
+            double meanWait;               // Of the customers served
+            int64_t maxWait;
+            double averageLineLength;      // Time average over the interval
+            uint64_t maxLineLength;
+        };
+
+    private:
+        int64_t width;                     // Length of every interval
+        IntervalSink &sink;
+        bool started = false;              // Whether the first event has set the clock
+        int64_t lastTime = 0;              // Time of the last advanceTo()
+        uint64_t waiting = 0;              // People waiting in line now
+        Interval current;                  // The interval in progress
+        int64_t totalWait = 0;             // Of the customers served in the current interval
+        double waitingArea = 0;            // Integral of waiting over the current interval
+
+        // Description: Starts an empty interval at start.
+        void begin(int64_t start);
+
+        // Description: Writes the current interval, which ends at time.
+        void end(int64_t time);
+
+    public:
+        // Description: Constructor, intervals of aWidth time units go to aSink.
+        // Precondition: aWidth > 0
+        IntervalMetrics(int64_t aWidth, IntervalSink &aSink);
+
+        // Description: Moves the clock to time, writing out every interval that ends by then.
+        //              The first call aligns the intervals to multiples of the width.
+        // Precondition: time is not before the time of the last call.
+        // Exceptions: Throws runtime_error if the sink cannot be written.
+        // Time Efficiency: O(1), plus O(1) per interval written
+        void advanceTo(int64_t time);
+
+        // Description: Records an arrival, or a departure, at the current time.
+        void arrival();
+        void departure();
+
+        // Description: Records the wait of a customer whose service starts now.
+        void recordWait(int64_t waitTime);
+
+        // Description: Records a customer joining, or leaving, a line.
+        void joinLine();
+        void leaveLine();
+
+        // Description: Writes out the interval in progress, which ends at the last event.
+        // Exceptions: Throws runtime_error if the sink cannot be written.
+        void finish();
+};
+
+
+// Where finished intervals go.
+class IntervalSink {
+
+    public:
+        // Description: Destructor
+        virtual ~IntervalSink();
+
+        // Description: Writes out one interval of width width.
+        // Exceptions: Throws runtime_error if it cannot be written.
+        virtual void write(const IntervalMetrics::Interval &interval, int64_t width) = 0;
+
+        // Description: Finishes the output. Nothing can be written after it.
+        // Exceptions: Throws runtime_error if it cannot be written.
+        virtual void close() = 0;
+};
+
+
+// Writes intervals to a CSV file, one line each after a header line.
+class CsvIntervalSink : public IntervalSink {
+
+    private:
+        FILE *file;
+
+    public:
+        // Description: Constructor, creates fileName and writes the header line.
+        // Exceptions: Throws runtime_error if the file cannot be created.
+        CsvIntervalSink(const std::string &fileName);
+
+        // Description: Destructor, closes the file if close() was not called.
+        ~CsvIntervalSink();
+
+        CsvIntervalSink(const CsvIntervalSink &) = delete;
+        CsvIntervalSink & operator=(const CsvIntervalSink &) = delete;
+
+        // Description: Writes out one interval as a line of text.
+        // Exceptions: Throws runtime_error if the file cannot be written.
+        void write(const IntervalMetrics::Interval &interval, int64_t width);
+
+        // Description: Closes the file.
+        // Exceptions: Throws runtime_error if the file cannot be written.
+        void close();
+};
+
+
+// Writes intervals to a binary file of fixed-width records.
+class BinaryIntervalSink : public IntervalSink {
+
+    public:
+        static char const MAGIC[8];
+        static uint32_t const VERSION = 1;
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t recordSize;           // sizeof(IntervalMetrics::Interval)
+            int64_t width;
+            uint64_t recordCount;
+        };
+
+    private:
+        FILE *file;
+        int64_t width = 0;
+        uint64_t recordCount = 0;
+
+    public:
+        // Description: Constructor, creates fileName and writes a provisional header.
+        // Exceptions: Throws runtime_error if the file cannot be created.
+        BinaryIntervalSink(const std::string &fileName);
+
+        // Description: Destructor, finishes the file if close() was not called.
+        ~BinaryIntervalSink();
+
+        BinaryIntervalSink(const BinaryIntervalSink &) = delete;
+        BinaryIntervalSink & operator=(const BinaryIntervalSink &) = delete;
+
+        // Description: Appends one interval record.
+        // Exceptions: Throws runtime_error if the file cannot be written.
+        void write(const IntervalMetrics::Interval &interval, int64_t width);
+
+        // Description: Writes the width and record count into the header and closes the file.
+        // Exceptions: Throws runtime_error if the file cannot be written.
+        void close();
+};
+#endif
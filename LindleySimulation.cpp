@@ -0,0 +1,379 @@
+/*
+ * LindleySimulation.cpp
+ *
+ * Description: The analytic fast path of Simulation for a single teller:
+ *              departures follow the Lindley recursion, so the events are a
+ *              merge of the arrivals with a FIFO of departures, without an
+ *              event queue; long runs may be scanned in parallel, chunk by
+ *              chunk (see LindleySimulation.h).
+ *
+ * Class Invariant: The customers in the bank are in arrival order, the first one
+ *                  being served, and their departure times are those the event
+ *                  engine would schedule.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include "LindleySimulation.h"
+#include "WorkStealingPool.h"
+#include "Instrumentation.h"
+
+// The teller was free long before any arrival: below every time, and far enough
+// from LLONG_MIN that adding the lengths of a whole trace cannot overflow.
+static long long const NO_TIME = LLONG_MIN / 4;
+
+
+// Description: Constructor
+LindleySimulation::Pass::Pass(SimulationStatistics &someStatistics, IntervalMetrics *someIntervals,
+                              TraceLog &aTraceLog, std::vector<int> *someWaits)
+    : statistics(someStatistics), intervals(someIntervals), traceLog(aTraceLog), waits(someWaits) { }
+
+// Records the wait of the customer whose service starts now
+void LindleySimulation::Pass::recordWait(int waitTime) {
+    if (waits != nullptr)
+        waits->push_back(waitTime);
+    else
+        statistics.recordWait(waitTime);
+    if (intervals != nullptr)
+        intervals->recordWait(waitTime);
+}
+
+// Processes the arrival of newArrival at its time
+//     The customer is served at once if the bank is empty; otherwise they join
+//     the line and leave max(A, D(n - 1)) + S = D(n - 1) + S later.
+void LindleySimulation::Pass::processArrival(const Event &newArrival) {
+    currentTime = newArrival.getTime();
+    statistics.advanceTo(currentTime);
+    if (intervals != nullptr)
+        intervals->advanceTo(currentTime);
+    traceLog.arrival(currentTime);
+    if (intervals != nullptr)
+        intervals->arrival();
+
+    Customer customer;
+    customer.arrivalTime = currentTime;
+    if (inBank.isEmpty()) {
+        recordWait(0);
+        statistics.tellerBusy();
+        customer.departureTime = currentTime + newArrival.getLength();
+    }
+    else {
+        statistics.joinLine();
+        if (intervals != nullptr)
+            intervals->joinLine();
+        customer.departureTime = lastDepartureTime + newArrival.getLength();
+    }
+    lastDepartureTime = customer.departureTime;
+    inBank.enqueue(customer);
+}
+
+// Description: Processes the departure of the first customer in the bank.
+//     The next customer, if any, waited from their arrival until now.
+void LindleySimulation::Pass::processDeparture() {
+    currentTime = inBank.peekUnchecked().departureTime;
+    inBank.dequeueUnchecked();
+    statistics.advanceTo(currentTime);
+    if (intervals != nullptr)
+        intervals->advanceTo(currentTime);
+    traceLog.departure(currentTime);
+    if (intervals != nullptr)
+        intervals->departure();
+
+    if (!inBank.isEmpty()) {
+        statistics.leaveLine();
+        if (intervals != nullptr)
+            intervals->leaveLine();
+        recordWait(currentTime - inBank.peekUnchecked().arrivalTime);
+    }
+    else
+        statistics.tellerIdle();
+}
+
+// Description: Returns true if the bank is empty by the time of newArrival.
+//              A departure at the very time of the arrival comes after it.
+bool LindleySimulation::Pass::isIdleAt(const Event &newArrival) const {
+    return inBank.isEmpty() || lastDepartureTime < newArrival.getTime();
+}
+
+// Description: Processes the departures before newArrival, then newArrival.
+//              Departures strictly before the arrival go first: at equal times
+//              the arrival comes first, as in the event queue.
+void LindleySimulation::Pass::process(const Event &newArrival) {
+    while (!inBank.isEmpty() && inBank.peekUnchecked().departureTime < newArrival.getTime())
+        processDeparture();
+    processArrival(newArrival);
+    customerCount++;
+}
+
+// Description: Processes the departures left.
+void LindleySimulation::Pass::finish() {
+    while (!inBank.isEmpty())
+        processDeparture();
+}
+
+// Description: Returns in time the departure time of the first customer in the bank,
+//              false if the bank is empty.
+bool LindleySimulation::Pass::peekDeparture(int &time) const {
+    if (inBank.isEmpty())
+        return false;
+    time = inBank.peekUnchecked().departureTime;
+    return true;
+}
+
+// Description: Returns the customers in the bank, in order, leaving them there.
+std::vector<LindleySimulation::Customer> LindleySimulation::Pass::getCustomers() {
+    std::vector<Customer> customers;
+    Customer customer;
+    while (inBank.tryDequeue(customer))
+        customers.push_back(customer);
+    for (size_t i = 0; i < customers.size(); i++)
+        inBank.enqueue(customers[i]);
+    return customers;
+}
+
+// Description: Puts someCustomers, in order, in the bank.
+void LindleySimulation::Pass::resume(const std::vector<Customer> &someCustomers) {
+    for (size_t i = 0; i < someCustomers.size(); i++)
+        inBank.enqueue(someCustomers[i]);
+    if (!someCustomers.empty())
+        lastDepartureTime = someCustomers.back().departureTime;
+}
+
+
+// Description: Constructor, one teller.
+LindleySimulation::LindleySimulation(LineDiscipline aDiscipline) : Simulation(1, aDiscipline) { }
+
+// Writes the customers in the bank to aCheckpoint
+void LindleySimulation::saveEngine(CheckpointWriter &aCheckpoint) {
+    aCheckpoint.putUInt8(Checkpoint::SINGLE_TELLER_ENGINE);
+    std::vector<Customer> customers;
+    if (sequential != nullptr)
+        customers = sequential->getCustomers();
+    aCheckpoint.putInt64(customers.size());
+    for (size_t i = 0; i < customers.size(); i++) {
+        aCheckpoint.putInt32(customers[i].arrivalTime);
+        aCheckpoint.putInt32(customers[i].departureTime);
+    }
+}
+
+// Reads the customers in the bank back from aCheckpoint, for the sequential pass
+void LindleySimulation::restoreEngine(CheckpointReader &aCheckpoint) {
+    if (aCheckpoint.getUInt8() != Checkpoint::SINGLE_TELLER_ENGINE)
+        throw std::runtime_error("checkpoint " + aCheckpoint.getFileName() + " is for the event driven engine (see --engine)");
+    int64_t count = aCheckpoint.getInt64();
+    if (count < 0)
+        throw std::runtime_error("checkpoint " + aCheckpoint.getFileName() + " is corrupt");
+    resumedInBank.clear();
+    for (int64_t i = 0; i < count; i++) {
+        Customer customer;
+        customer.arrivalTime = aCheckpoint.getInt32();
+        customer.departureTime = aCheckpoint.getInt32();
+        resumedInBank.push_back(customer);
+    }
+}
+
+// Runs the recursion over arrivals one event at a time,
+// from the checkpoint resumed if there is one
+void LindleySimulation::runSequential(ArrivalReader &arrivals) {
+    Pass pass(statistics, intervals, *traceLog);
+    pass.currentTime = currentTime;
+    pass.customerCount = customerCount;
+    pass.resume(resumedInBank);
+    resumedInBank.clear();
+    sequential = &pass;
+
+    Event newArrivalEvent;
+    while (readArrival(arrivals, newArrivalEvent)) {
+        pass.process(newArrivalEvent);
+
+        // A checkpoint is taken before the next arrival is read
+        if (checkpoints != nullptr) {
+            currentTime = pass.currentTime;
+            customerCount = pass.customerCount;
+            if (checkpointIfDue())
+                break;
+        }
+    }
+    if (!isStopped())
+        pass.finish();
+
+    sequential = nullptr;
+    currentTime = pass.currentTime;
+    customerCount = pass.customerCount;
+}
+
+// Returns the pass of a run driven by the caller, begun on first use
+// from the checkpoint resumed if there is one
+LindleySimulation::Pass & LindleySimulation::drivenPass() {
+    if (driven == nullptr) {
+        driven.reset(new Pass(statistics, intervals, *traceLog));
+        driven->currentTime = currentTime;
+        driven->customerCount = customerCount;
+        driven->resume(resumedInBank);
+        resumedInBank.clear();
+        sequential = driven.get();
+    }
+    return *driven;
+}
+
+// Returns in time the time of the first event of a run driven by the caller:
+// the first departure, or the next arrival given if it is not after it
+bool LindleySimulation::peekEvent(int &time, bool &arriving) {
+    bool departing = drivenPass().peekDeparture(time);
+    arriving = !pushedArrivals.isEmpty()
+               && (!departing || pushedArrivals.peekUnchecked().getTime() <= time);
+    if (arriving)
+        time = pushedArrivals.peekUnchecked().getTime();
+    return departing || arriving;
+}
+
+// Processes the first event of a run driven by the caller
+void LindleySimulation::processNextEvent() {
+    Pass &pass = drivenPass();
+    int time;
+    bool arriving;
+    peekEvent(time, arriving);
+    if (arriving) {
+        pass.process(pushedArrivals.peekUnchecked());      // No departure is before it
+        pushedArrivals.dequeueUnchecked();
+    }
+    else
+        pass.processDeparture();
+    currentTime = pass.currentTime;
+    customerCount = pass.customerCount;
+}
+
+// Runs the recursion over arrivals by a parallel prefix scan.
+// Returns false, having done nothing, if arrivals are unfit for it.
+//     1. In parallel, each chunk folds its customers into the map (p, q) of the
+//        time the teller is free before the chunk to the time it is free after it,
+//        checking on the way that the lengths are not negative.
+//     2. A sequential exclusive scan over the maps gives the carry-in of each chunk.
+//     3. In parallel, each chunk skips the customers of the busy period it inherits,
+//        simulates from the next busy period on, and goes past its end until the
+//        teller is idle again: where the next chunk starts.
+//     The statistics of the chunks are merged in order, then the waits are recorded
+//     in customer order, as the sequential pass records them.
+bool LindleySimulation::runParallel(const ArrivalBuffer &arrivals) {
+    size_t arrivalCount = arrivals.getElementCount();
+    size_t numberOfChunks = std::min(size_t(numberOfThreads) * CHUNKS_PER_THREAD, arrivalCount / MIN_CHUNK);
+    if (numberOfChunks < 2)
+        return false;
+
+    std::vector<size_t> first(numberOfChunks + 1);    // Chunk k is first[k] to first[k + 1] - 1
+    for (size_t k = 0; k <= numberOfChunks; k++)
+        first[k] = arrivalCount * k / numberOfChunks;
+    WorkStealingPool pool(std::min(size_t(numberOfThreads), numberOfChunks));
+
+    // 1. The map of each chunk
+    std::vector<long long> p(numberOfChunks, NO_TIME);
+    std::vector<long long> q(numberOfChunks, 0);
+    std::vector<char> fit(numberOfChunks, 1);
+    for (size_t k = 0; k < numberOfChunks; k++)
+        pool.submit([&, k](unsigned int) {
+            long long chunkP = NO_TIME;
+            long long chunkQ = 0;
+            for (size_t i = first[k]; i < first[k + 1]; i++) {
+                const Event &newArrival = arrivals.at(i);
+                if (newArrival.getLength() < 0) {
+                    fit[k] = 0;
+                    return;
+                }
+                chunkP = std::max(chunkP, newArrival.getTime() - chunkQ);
+                chunkQ += newArrival.getLength();
+            }
+            p[k] = chunkP;
+            q[k] = chunkQ;
+        });
+    pool.run();
+    if (std::find(fit.begin(), fit.end(), 0) != fit.end())
+        return false;
+
+    // 2. The time the teller is free before each chunk
+    std::vector<long long> freeAt(numberOfChunks + 1);
+    freeAt[0] = NO_TIME;
+    for (size_t k = 0; k < numberOfChunks; k++)
+        freeAt[k + 1] = std::max(p[k], freeAt[k]) + q[k];
+    if (freeAt[numberOfChunks] > INT_MAX)     // The departure times would overflow
+        return false;
+
+    // 3. The chunks, each from the first busy period that starts in it
+    std::vector<SimulationStatistics> chunkStatistics(numberOfChunks, SimulationStatistics(1));
+    std::vector<std::vector<int>> chunkWaits(numberOfChunks);
+    std::vector<long long> chunkCustomers(numberOfChunks, 0);
+    std::vector<int> chunkTime(numberOfChunks, 0);
+    for (size_t k = 0; k < numberOfChunks; k++)
+        pool.submit([&, k](unsigned int) {
+            size_t start = first[k];
+            long long freeTime = freeAt[k];
+            while (start < first[k + 1] && freeTime >= arrivals.at(start).getTime())
+                freeTime += arrivals.at(start++).getLength();
+            if (start == first[k + 1])    // All in a busy period of an earlier chunk
+                return;
+            if (start > 0)                // The clock starts at the departure before
+                chunkStatistics[k].advanceTo(freeTime);
+
+            std::ostringstream quiet;
+            TraceLog quietLog(quiet, TraceLog::SUMMARY);
+            Pass pass(chunkStatistics[k], nullptr, quietLog, &chunkWaits[k]);
+            chunkWaits[k].reserve(first[k + 1] - start);
+            for (size_t i = start; i < arrivalCount; i++) {
+                const Event &newArrival = arrivals.at(i);
+                if (i >= first[k + 1] && pass.isIdleAt(newArrival))
+                    break;
+                pass.process(newArrival);
+            }
+            pass.finish();
+            chunkCustomers[k] = pass.customerCount;
+            chunkTime[k] = pass.currentTime;
+        });
+    pool.run();
+
+    for (size_t k = 0; k < numberOfChunks; k++) {
+        if (chunkCustomers[k] == 0)
+            continue;
+        statistics.merge(chunkStatistics[k]);
+        customerCount += chunkCustomers[k];
+        currentTime = chunkTime[k];
+    }
+    for (size_t k = 0; k < numberOfChunks; k++)
+        for (size_t i = 0; i < chunkWaits[k].size(); i++)
+            statistics.recordWait(chunkWaits[k][i]);
+    statistics.advanceTo(currentTime);       // Leaves the clock where the sequential pass does
+    return true;
+}
+
+// Description: Runs the simulation over all arrivals, logging events to aTraceLog.
+//              Without an event log, interval metrics or checkpoints, and with more
+//              than one thread, the arrivals are read in full and scanned in parallel.
+void LindleySimulation::run(ArrivalReader &arrivals, TraceLog &aTraceLog) {
+    BSIM_PHASE(RUN);
+    traceLog = &aTraceLog;
+
+    if (numberOfThreads > 1 && !aTraceLog.isTracing() && intervals == nullptr && checkpoints == nullptr
+        && customerCount == 0) {
+        std::vector<Event> allArrivals;
+        Event newArrivalEvent;
+        while (readArrival(arrivals, newArrivalEvent))
+            allArrivals.push_back(newArrivalEvent);
+        ArrivalBuffer buffer(std::move(allArrivals));
+
+        if (!runParallel(buffer)) {
+            // Read them again, from the buffer
+            lastArrivalTime = INT_MIN;
+            arrivalsRead = 0;
+            BufferedArrivalReader bufferedArrivals(buffer);
+            runSequential(bufferedArrivals);
+        }
+    }
+    else
+        runSequential(arrivals);
+
+    if (intervals != nullptr && !isStopped())
+        intervals->finish();
+    traceLog->flush();
+}
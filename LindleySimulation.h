@@ -0,0 +1,144 @@
+/*
+ * LindleySimulation.h
+ *
+ * Description: The analytic fast path of Simulation for a single teller.
+ *              With one teller and one FIFO line, customer n starts when they
+ *              arrive or when customer n - 1 leaves, whichever is later, so
+ *              departures follow the Lindley recursion
+ *                  D(n) = max(A(n), D(n - 1)) + S(n),
+ *              equivalently W(n + 1) = max(0, W(n) + S(n) - (A(n + 1) - A(n))).
+ *              Departures then come out in customer order and need no event
+ *              queue: the events are the merge of the sorted arrivals with the
+ *              departures of the customers still in the bank, kept in a FIFO.
+ *              The statistics, interval metrics and event log are updated in
+ *              exactly the order EventSimulation updates them, so the results
+ *              are identical, bit for bit. EventSimulation stays the reference
+ *              (see Simulation::createEventDriven() and bsim --crosscheck).
+ *
+ *              Parallel scan: a run with more than one thread (setThreadCount()),
+ *              no event log, interval metrics or checkpoints reads all arrivals, cuts them
+ *              into chunks and simulates the chunks concurrently. Each chunk maps
+ *              the time the teller becomes free before it, x, to the time it
+ *              becomes free after it, max(p, x) + q, and such maps compose:
+ *              (p1, q1) then (p2, q2) is (max(p1, p2 - q1), q1 + q2). The maps of
+ *              the chunks are computed in parallel and a prefix scan over them
+ *              gives the carry-in of every chunk. A chunk then starts at the first
+ *              customer who finds the teller free (the start of a busy period), so
+ *              the chunks share no events. The time averages merge exactly; the
+ *              waits are recorded in customer order at the end, so the Welford
+ *              moments are also bit for bit those of the sequential run.
+ *              Negative lengths or times that overflow fall back to the sequential
+ *              pass, which handles them as it always has.
+ *
+ * Class Invariant: The customers in the bank are in arrival order, the first one
+ *                  being served, and their departure times are those the event
+ *                  engine would schedule.
+ */
+
+#ifndef LINDLEY_SIMULATION_H
+#define LINDLEY_SIMULATION_H
+
+#include <memory>
+#include <vector>
+#include "Event.h"
+#include "Queue.h"
+#include "Simulation.h"
+
+class LindleySimulation : public Simulation {
+
+    private:
+        static size_t const MIN_CHUNK = 1 << 16;    // Fewest customers worth a chunk of their own
+        static unsigned int const CHUNKS_PER_THREAD = 4;
+
+        // A customer in the bank, being served or waiting in line
+        struct Customer {
+            int arrivalTime;
+            int departureTime;
+        };
+
+        // The recursion over consecutive arrivals, starting with an empty bank
+        class Pass {
+
+            private:
+                SimulationStatistics &statistics;
+                IntervalMetrics *intervals;             // Or nullptr
+                TraceLog &traceLog;
+                std::vector<int> *waits;                // If set, waits are kept here instead of recorded
+                Queue<Customer, LazyShrink> inBank;     // Customers that arrived and have not left, in order
+                int lastDepartureTime = 0;              // Departure time of the last customer in the bank
+
+                // Records the wait of the customer whose service starts now
+                void recordWait(int waitTime);
+
+                // Processes the arrival of newArrival at its time
+                void processArrival(const Event &newArrival);
+
+            public:
+                int currentTime = 0;
+                long long customerCount = 0;
+
+                // Description: Constructor
+                Pass(SimulationStatistics &someStatistics, IntervalMetrics *someIntervals,
+                     TraceLog &aTraceLog, std::vector<int> *someWaits = nullptr);
+
+                // Description: Returns true if the bank is empty by the time of newArrival.
+                bool isIdleAt(const Event &newArrival) const;
+
+                // Description: Processes the departures before newArrival, then newArrival.
+                void process(const Event &newArrival);
+
+                // Description: Processes the departures left.
+                void finish();
+
+                // Description: Returns in time the departure time of the first customer
+                //              in the bank, false if the bank is empty.
+                bool peekDeparture(int &time) const;
+
+                // Description: Processes the departure of the first customer in the bank.
+                // Precondition: The bank is not empty.
+                void processDeparture();
+
+                // Description: Returns the customers in the bank, in order, leaving them there.
+                std::vector<Customer> getCustomers();
+
+                // Description: Puts someCustomers, in order, in the bank.
+                // Precondition: The bank is empty.
+                void resume(const std::vector<Customer> &someCustomers);
+        };
+
+        Pass *sequential = nullptr;                 // The sequential pass, while it runs
+        std::unique_ptr<Pass> driven;               // The pass of a run driven by the caller, once begun
+        std::vector<Customer> resumedInBank;        // Customers in the bank at the checkpoint resumed
+
+        // Writes the customers in the bank to aCheckpoint, and reads them back
+        void saveEngine(CheckpointWriter &aCheckpoint);
+        void restoreEngine(CheckpointReader &aCheckpoint);
+
+        // Runs the recursion over arrivals one event at a time
+        void runSequential(ArrivalReader &arrivals);
+
+        // Runs the recursion over arrivals by a parallel prefix scan.
+        // Returns false, having done nothing, if arrivals are unfit for it.
+        bool runParallel(const ArrivalBuffer &arrivals);
+
+        // Returns the pass of a run driven by the caller, begun on first use
+        Pass &drivenPass();
+
+        // Steps of a run driven by the caller
+        bool peekEvent(int &time, bool &arriving);
+        void processNextEvent();
+
+    public:
+        // Description: Constructor, one teller.
+        LindleySimulation(LineDiscipline aDiscipline = SHARED_LINE);
+
+        // Description: Runs the simulation over all arrivals, logging events to aTraceLog.
+        // Precondition: arrivals are sorted by time.
+        // Exceptions: Throws runtime_error if the arrivals are not sorted by time,
+        //             or the interval metrics cannot be written,
+        //             and whatever arrivals throws when it cannot be read.
+        // Time Efficiency: O(n), O(1) per event; O(n / threads) plus O(n) recording
+        //                  the waits in the parallel scan
+        void run(ArrivalReader &arrivals, TraceLog &aTraceLog);
+};
+#endif
@@ -0,0 +1,94 @@
+/*
+ * MonotonicArena.cpp
+ *
+ * Description: Monotonic (bump pointer) arena for the memory of one simulation run.
+ *              The arena hands out consecutive pieces of one pre-sized block and
+ *              never frees them one by one: reset() gives the whole block back
+ *              at once when the run is over.
+ *
+ * Class Invariant: used <= capacity; peak is the most memory a run has used so far.
+ */
+
+#include <cstdint>
+#include "MonotonicArena.h"
+
+// Description: Constructor, takes a block of aCapacity bytes from the system.
+MonotonicArena::MonotonicArena(size_t aCapacity) : capacity(aCapacity) {
+    block = static_cast<char *>(::operator new(capacity));
+}
+
+// Description: Destructor, gives all the memory back to the system.
+MonotonicArena::~MonotonicArena() {
+    releaseChunks();
+    ::operator delete(block);
+}
+
+// Description: Gives the extra chunks back to the system.
+void MonotonicArena::releaseChunks() {
+    while (chunks != nullptr) {
+        Chunk *next = chunks->next;
+        ::operator delete(chunks);
+        chunks = next;
+    }
+    chunkBytes = 0;
+}
+
+// Description: Returns bytes of memory aligned to alignment (a power of 2).
+//              Carves the memory off the block, or takes a chunk of its own
+//              from the system once the block is full.
+void *MonotonicArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(block) + used;
+    size_t padding = (alignment - address % alignment) % alignment;
+
+    if (padding + bytes <= capacity - used) {
+        used += padding + bytes;
+        if (used + chunkBytes > peak)
+            peak = used + chunkBytes;
+        return block + used - bytes;
+    }
+
+    // The block is full: the chunk starts with its header, padded to max_align_t
+    size_t header = (sizeof(Chunk) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    Chunk *chunk = static_cast<Chunk *>(::operator new(header + bytes));
+    chunk->next = chunks;
+    chunks = chunk;
+    chunkBytes += bytes;
+    overflowCount++;
+    if (used + chunkBytes > peak)
+        peak = used + chunkBytes;
+    return reinterpret_cast<char *>(chunk) + header;
+}
+
+// Description: Makes the whole block available again.
+//              If the last run overflowed, the block is replaced by one that
+//              holds the peak with 1/8 to spare (for alignment padding), so
+//              the following runs fit in it.
+void MonotonicArena::reset() {
+    if (chunks != nullptr) {
+        releaseChunks();
+        ::operator delete(block);
+        capacity = peak + peak / 8;
+        block = static_cast<char *>(::operator new(capacity));
+    }
+    used = 0;
+}
+
+// Description: Returns the size of the block in bytes.
+size_t MonotonicArena::getCapacity() const {
+    return capacity;
+}
+
+// Description: Returns the bytes handed out since the last reset.
+size_t MonotonicArena::getUsed() const {
+    return used + chunkBytes;
+}
+
+// Description: Returns the most bytes handed out between two resets.
+size_t MonotonicArena::getPeakUsage() const {
+    return peak;
+}
+
+// Description: Returns the number of allocations that did not fit in the block.
+unsigned long long MonotonicArena::getOverflowCount() const {
+    return overflowCount;
+}
@@ -0,0 +1,127 @@
+/*
+ * MonotonicArena.h
+ *
+ * Description: Monotonic (bump pointer) arena for the memory of one simulation run,
+ *              and ArenaAllocator, the allocator that lets Queue and BinaryHeap
+ *              take their arrays from it.
+ *              The arena hands out consecutive pieces of one pre-sized block and
+ *              never frees them one by one: deallocating is a no-op, and reset()
+ *              gives the whole block back at once when the run is over.
+ *              If a run needs more than the block, the arena takes extra chunks
+ *              from the system rather than fail, and the next reset() replaces the
+ *              block by one with room for the peak, so later runs fit in it.
+ *              An arena is not thread safe: give each thread its own.
+ *
+ * Class Invariant: used <= capacity; peak is the most memory a run has used so far.
+ */
+
+#ifndef MONOTONIC_ARENA_H
+#define MONOTONIC_ARENA_H
+
+#include <cstddef>
+#include <new>
+
+class MonotonicArena {
+
+    private:
+        // Header of a chunk taken from the system when the block is full
+        struct Chunk {
+            Chunk *next;
+        };
+
+        char *block;                     // The pre-sized block
+        size_t capacity;                 // Size of block in bytes
+        size_t used = 0;                 // Bytes of block handed out since the last reset
+        Chunk *chunks = nullptr;         // Extra chunks since the last reset
+        size_t chunkBytes = 0;           // Bytes handed out from extra chunks since the last reset
+        size_t peak = 0;                 // Most bytes handed out between two resets
+        unsigned long long overflowCount = 0;   // Allocations that did not fit in the block
+
+        void releaseChunks();            // Gives the extra chunks back to the system
+
+    public:
+        // Description: Constructor, takes a block of aCapacity bytes from the system.
+        // Exceptions: Throws bad_alloc if the block cannot be allocated.
+        MonotonicArena(size_t aCapacity);
+
+        // Description: Destructor, gives all the memory back to the system.
+        ~MonotonicArena();
+
+        MonotonicArena(const MonotonicArena &) = delete;
+        MonotonicArena & operator=(const MonotonicArena &) = delete;
+
+        // Description: Returns bytes of memory aligned to alignment (a power of 2).
+        //              The memory stays valid until the next reset().
+        // Precondition: alignment <= alignof(std::max_align_t)
+        // Exceptions: Throws bad_alloc if the block is full and the system has no memory.
+        // Time Efficiency: O(1)
+        void *allocate(size_t bytes, size_t alignment);
+
+        // Description: Makes the whole block available again. Every piece handed out
+        //              since the last reset becomes invalid.
+        // Time Efficiency: O(1) if the run fitted in the block
+        void reset();
+
+        // Description: Returns the size of the block in bytes.
+        size_t getCapacity() const;
+
+        // Description: Returns the bytes handed out since the last reset.
+        size_t getUsed() const;
+
+        // Description: Returns the most bytes handed out between two resets.
+        size_t getPeakUsage() const;
+
+        // Description: Returns the number of allocations that did not fit in the block.
+        unsigned long long getOverflowCount() const;
+};
+
+
+// Allocator for the container templates (Queue, BinaryHeap) taking memory from a
+// MonotonicArena. Without an arena it falls back to operator new and delete.
+// Memory from an arena is only given back by MonotonicArena::reset(), so containers
+// using it should not shrink (NeverShrink): a shrunk array would just be wasted.
+template <class ElementType>
+class ArenaAllocator {
+
+    private:
+        MonotonicArena *arena;
+
+    public:
+        typedef ElementType value_type;
+
+        // Description: Constructor
+        ArenaAllocator(MonotonicArena *anArena = nullptr) : arena(anArena) { }
+
+        // Description: Converting constructor, shares the arena of anAllocator.
+        template <class OtherType>
+        ArenaAllocator(const ArenaAllocator<OtherType> &anAllocator) : arena(anAllocator.getArena()) { }
+
+        // Description: Returns the arena, nullptr if there is none.
+        MonotonicArena *getArena() const {
+            return arena;
+        }
+
+        // Description: Returns uninitialized memory for count elements.
+        ElementType *allocate(size_t count) {
+            if (arena == nullptr)
+                return static_cast<ElementType *>(::operator new(count * sizeof(ElementType)));
+            return static_cast<ElementType *>(arena->allocate(count * sizeof(ElementType), alignof(ElementType)));
+        }
+
+        // Description: Gives back memory from allocate(); the arena keeps it until its reset().
+        void deallocate(ElementType *elements, size_t) {
+            if (arena == nullptr)
+                ::operator delete(elements);
+        }
+};
+
+template <class ElementType, class OtherType>
+bool operator==(const ArenaAllocator<ElementType> &lhs, const ArenaAllocator<OtherType> &rhs) {
+    return lhs.getArena() == rhs.getArena();
+}
+
+template <class ElementType, class OtherType>
+bool operator!=(const ArenaAllocator<ElementType> &lhs, const ArenaAllocator<OtherType> &rhs) {
+    return lhs.getArena() != rhs.getArena();
+}
+#endif
@@ -0,0 +1,107 @@
+/*
+ * ParameterSweep.cpp
+ *
+ * Description: Runs the same arrivals through many independent simulations,
+ *              one per combination of teller count and service time scaling,
+ *              on a pool of worker threads, and collects the results in one table.
+ *              The arrivals are parsed once and shared read-only by all runs;
+ *              each run owns its own Simulation (event queue, lines, tellers).
+ *              With the binary heap scheduler, every worker thread keeps one
+ *              MonotonicArena for the event queue and lines of its runs and resets
+ *              it between runs, so a run costs no allocator traffic once the arena
+ *              has grown to fit. Single teller runs take the analytic fast path
+ *              (LindleySimulation), which needs no arena.
+ *
+ * Class Invariant: Results are kept in the order the runs were added.
+ */
+
+#include <atomic>
+#include <exception>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include "ParameterSweep.h"
+#include "TraceLog.h"
+
+using std::endl;
+using std::setw;
+
+
+// Description: Constructor
+ParameterSweep::ParameterSweep(const ArrivalBuffer &someArrivals, Simulation::LineDiscipline aDiscipline,
+                               Simulation::Scheduler aScheduler, size_t anArenaSize)
+    : arrivals(someArrivals), discipline(aDiscipline), scheduler(aScheduler), arenaSize(anArenaSize) { }
+
+// Description: Adds a run with numberOfTellers tellers and lengths scaled by serviceScale.
+void ParameterSweep::addRun(unsigned int numberOfTellers, double serviceScale) {
+    Run newRun;
+    newRun.numberOfTellers = numberOfTellers;
+    newRun.serviceScale = serviceScale;
+    runs.push_back(newRun);
+}
+
+// Description: Simulates runs[index], taking memory from arena.
+//              The arena is reset once the simulation is gone.
+void ParameterSweep::simulate(unsigned int index, MonotonicArena &arena) {
+    Run &aRun = runs[index];
+    try {
+        std::unique_ptr<Simulation> simulation(Simulation::create(aRun.numberOfTellers, discipline, scheduler, &arena));
+        BufferedArrivalReader reader(arrivals, aRun.serviceScale);
+        std::ostringstream messages;
+        TraceLog traceLog(messages, TraceLog::SUMMARY);
+
+        simulation->run(reader, traceLog);
+        aRun.customerCount = simulation->getCustomerCount();
+        aRun.totalWait = simulation->getTotalWait();
+        aRun.p99Wait = simulation->getStatistics().getWaitQuantiles().quantile(0.99);
+        aRun.utilization = simulation->getStatistics().getUtilization();
+    }
+    catch (std::exception &anException) {
+        aRun.error = anException.what();
+    }
+    aRun.memoryUsed = arena.getUsed();
+    arena.reset();
+}
+
+// Description: Simulates every run, using up to numberOfThreads threads.
+//              Workers take the next run not yet started until none is left.
+void ParameterSweep::run(unsigned int numberOfThreads) {
+    std::atomic<unsigned int> nextRun(0);
+    auto worker = [this, &nextRun]() {
+        MonotonicArena arena(arenaSize);
+        unsigned int index;
+        while ((index = nextRun++) < runs.size())
+            simulate(index, arena);
+    };
+
+    if (numberOfThreads > runs.size())
+        numberOfThreads = runs.size();
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < numberOfThreads; i++)
+        workers.emplace_back(worker);
+    worker();      // This thread works too
+    for (unsigned int i = 0; i < workers.size(); i++)
+        workers[i].join();
+}
+
+// Description: Returns the runs with their results.
+const std::vector<ParameterSweep::Run> & ParameterSweep::getRuns() const {
+    return runs;
+}
+
+// Description: Prints one line per run.
+void ParameterSweep::printTable(std::ostream &output) const {
+    output << "Tellers  Service scale  Customers  Average wait  p99 wait  Utilization  Memory (KiB)" << endl;
+    for (unsigned int i = 0; i < runs.size(); i++) {
+        const Run &aRun = runs[i];
+        output << setw(7) << aRun.numberOfTellers << "  " << setw(13) << aRun.serviceScale << "  ";
+        if (!aRun.error.empty())
+            output << "error: " << aRun.error << endl;
+        else
+            output << setw(9) << aRun.customerCount << "  " << setw(12)
+                   << float(aRun.totalWait)/float(aRun.customerCount) << "  " << setw(8)
+                   << aRun.p99Wait << "  " << setw(11) << aRun.utilization << "  " << setw(12)
+                   << (aRun.memoryUsed + 1023) / 1024 << endl;
+    }
+}
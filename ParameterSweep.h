@@ -0,0 +1,72 @@
+/*
+ * ParameterSweep.h
+ *
+ * Description: Runs the same arrivals through many independent simulations,
+ *              one per combination of teller count and service time scaling,
+ *              on a pool of worker threads, and collects the results in one table.
+ *              The arrivals are parsed once and shared read-only by all runs;
+ *              each run owns its own Simulation (event queue, lines, tellers).
+ *              With the binary heap scheduler, every worker thread keeps one
+ *              MonotonicArena for the event queue and lines of its runs and resets
+ *              it between runs, so a run costs no allocator traffic once the arena
+ *              has grown to fit. Single teller runs take the analytic fast path
+ *              (LindleySimulation), which needs no arena.
+ *
+ * Class Invariant: Results are kept in the order the runs were added.
+ */
+
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ArrivalReader.h"
+#include "Simulation.h"
+
+class ParameterSweep {
+
+    public:
+        // Parameters and results of one simulation run
+        struct Run {
+            unsigned int numberOfTellers;
+            double serviceScale;           // Every transaction length is multiplied by this
+            long long customerCount = 0;
+            long long totalWait = 0;
+            long long p99Wait = 0;         // 99th percentile of the wait
+            double utilization = 0;        // Fraction of the time the tellers were busy
+            size_t memoryUsed = 0;         // Bytes of arena the run used, 0 without an arena
+            std::string error = "";        // Why the run failed, empty if it succeeded
+        };
+
+    private:
+        const ArrivalBuffer &arrivals;
+        Simulation::LineDiscipline discipline;
+        Simulation::Scheduler scheduler;
+        size_t arenaSize;                  // Initial size of each worker's arena
+        std::vector<Run> runs;
+
+        // Description: Simulates runs[index], taking memory from arena.
+        void simulate(unsigned int index, MonotonicArena &arena);
+
+    public:
+        static size_t const DEFAULT_ARENA_SIZE = 1 << 20;   // Bytes
+
+        // Description: Constructor
+        ParameterSweep(const ArrivalBuffer &someArrivals, Simulation::LineDiscipline aDiscipline,
+                       Simulation::Scheduler aScheduler = Simulation::BINARY_HEAP,
+                       size_t anArenaSize = DEFAULT_ARENA_SIZE);
+
+        // Description: Adds a run with numberOfTellers tellers and lengths scaled by serviceScale.
+        void addRun(unsigned int numberOfTellers, double serviceScale);
+
+        // Description: Simulates every run, using up to numberOfThreads threads.
+        void run(unsigned int numberOfThreads);
+
+        // Description: Returns the runs with their results.
+        const std::vector<Run> &getRuns() const;
+
+        // Description: Prints one line per run.
+        void printTable(std::ostream &output) const;
+};
+#endif
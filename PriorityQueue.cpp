@@ -2,6 +2,8 @@
  * PriorityQueue.cpp
  *
  * Description: Models a Priority Queue
+ *              HeapType is the heap holding the elements: BinaryHeap by default,
+ *              or any heap with the same interface (e.g. DaryHeap).
  *
  * Class Invariant: FIFO or LILO order using priority value
  *                  Sorted by time and type
@@ -12,31 +14,37 @@
  */
 
 #include <iostream>
+#include <utility>
 #include "PriorityQueue.h"
 
 using std::cout;
 using std::endl;
 
 // Description: Constructor
-template <class ElementType>
-PriorityQueue<ElementType>::PriorityQueue() {
+template <class ElementType, class HeapType>
+PriorityQueue<ElementType, HeapType>::PriorityQueue() {
     elementCount = 0;
 }
 
+// Description: Constructor, the heap takes its memory from anAllocator.
+template <class ElementType, class HeapType>
+template <class Allocator>
+PriorityQueue<ElementType, HeapType>::PriorityQueue(const Allocator &anAllocator) : queueP(anAllocator) { }
+
 
 // Description: Returns the number of elements in the Priority Queue.
 // Postcondition: The Priority Queue is unchanged by this operation.
 // Time Efficiency: O(1)
-template <class ElementType>
-unsigned int PriorityQueue<ElementType>::getElementCount() const {
+template <class ElementType, class HeapType>
+unsigned int PriorityQueue<ElementType, HeapType>::getElementCount() const {
     return elementCount;
 }
 
 // Description: Returns true if this Priority Queue is empty, otherwise false.
 // Postcondition: This Priority Queue is unchanged by this operation.
 // Time Efficiency: O(1)
-template <class ElementType>
-bool PriorityQueue<ElementType>::isEmpty() const {
+template <class ElementType, class HeapType>
+bool PriorityQueue<ElementType, HeapType>::isEmpty() const {
     if (queueP.getElementCount() == 0)
         return true;
     return false;
@@ -45,25 +53,58 @@ bool PriorityQueue<ElementType>::isEmpty() const {
 // Description: Inserts newElement in this Priority Queue and
 //              returns true if successful, otherwise false.
 // Time Efficiency: O(log2 n)
-template <class ElementType>
-bool PriorityQueue<ElementType>::enqueue(ElementType &newElement) {
+template <class ElementType, class HeapType>
+bool PriorityQueue<ElementType, HeapType>::enqueue(const ElementType &newElement) {
     queueP.insert(newElement);
     elementCount++;
 
     return true;
 }
 
+// Description: Same as enqueue(), but moves newElement into the heap instead of copying it.
+// Time Efficiency: O(log2 n)
+template <class ElementType, class HeapType>
+bool PriorityQueue<ElementType, HeapType>::enqueue(ElementType &&newElement) {
+    queueP.insert(std::move(newElement));
+    elementCount++;
+
+    return true;
+}
+
+// Description: Constructs a new element from arguments and inserts it in this Priority Queue.
+//              Returns true if successful, otherwise false.
+// Time Efficiency: O(log2 n)
+template <class ElementType, class HeapType>
+template <class... Arguments>
+bool PriorityQueue<ElementType, HeapType>::emplace(Arguments &&... arguments) {
+    return enqueue(ElementType(std::forward<Arguments>(arguments)...));
+}
+
+// Description: Removes (but does not return) the element with the next "highest" priority value,
+//              without checking that there is one.
+template <class ElementType, class HeapType>
+void PriorityQueue<ElementType, HeapType>::dequeueUnchecked() {
+    queueP.removeUnchecked();
+    elementCount--;
+}
+
 // Description: Removes (but does not return) the element with the next
 //              "highest" priority value from the Priority Queue.
 // Precondition: This Priority Queue is not empty.
 // Exception: Throws EmptyDataCollectionException if Priority Queue is empty.
 // Time Efficiency: O(log2 n)
-template <class ElementType>
-void PriorityQueue<ElementType>::dequeue() {
+template <class ElementType, class HeapType>
+void PriorityQueue<ElementType, HeapType>::dequeue() {
     if(isEmpty())
         throw EmptyDataCollectionException("dequeue() called on an empty Priority Queue.");
-    queueP.remove();
-    elementCount--;
+    dequeueUnchecked();
+}
+
+// Description: Returns (but does not remove) the element with the next "highest" priority value,
+//              without checking that there is one.
+template <class ElementType, class HeapType>
+ElementType & PriorityQueue<ElementType, HeapType>::peekUnchecked() const {
+    return queueP.retrieveUnchecked();
 }
 
 // Description: Returns (but does not remove) the element with the next
@@ -72,9 +113,47 @@ void PriorityQueue<ElementType>::dequeue() {
 // Postcondition: This Priority Queue is unchanged by this operation.
 // Exception: Throws EmptyDataCollectionException if this Priority Queue is empty.
 // Time Efficiency: O(1)
-template <class ElementType>
-ElementType & PriorityQueue<ElementType>::peek() const {
+template <class ElementType, class HeapType>
+ElementType & PriorityQueue<ElementType, HeapType>::peek() const {
     if(isEmpty())
         throw EmptyDataCollectionException("peek() called on an empty Priority Queue.");
-    return queueP.retrieve();
-}
\ No newline at end of file
+    return peekUnchecked();
+}
+
+// Description: Removes the element with the next "highest" priority value from the
+//              Priority Queue and returns it, moved out rather than copied.
+// Precondition: This Priority Queue is not empty.
+// Exception: Throws EmptyDataCollectionException if this Priority Queue is empty.
+// Time Efficiency: O(log2 n)
+template <class ElementType, class HeapType>
+ElementType PriorityQueue<ElementType, HeapType>::pop() {
+    if(isEmpty())
+        throw EmptyDataCollectionException("pop() called on an empty Priority Queue.");
+    ElementType front(std::move(peekUnchecked()));
+    dequeueUnchecked();
+    return front;
+}
+
+// Description: If this Priority Queue is not empty, moves its front element into front,
+//              removes it and returns true; otherwise returns false.
+template <class ElementType, class HeapType>
+bool PriorityQueue<ElementType, HeapType>::tryDequeue(ElementType &front) {
+    if (isEmpty())
+        return false;
+    front = std::move(peekUnchecked());
+    dequeueUnchecked();
+    return true;
+}
+
+// Description: Makes room for at least newCapacity elements in the heap,
+//              so it can grow to that many without reallocating.
+template <class ElementType, class HeapType>
+void PriorityQueue<ElementType, HeapType>::reserve(unsigned int newCapacity) {
+    queueP.reserve(newCapacity);
+}
+
+// Description: Returns the number of times the heap reallocated its array.
+template <class ElementType, class HeapType>
+unsigned long long PriorityQueue<ElementType, HeapType>::getReallocationCount() const {
+    return queueP.getReallocationCount();
+}
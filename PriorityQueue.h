@@ -2,6 +2,8 @@
  * PriorityQueue.h
  *
  * Description: Models a Priority Queue
+ *              HeapType is the heap holding the elements: BinaryHeap by default,
+ *              or any heap with the same interface (e.g. DaryHeap).
  *
  * Class Invariant: FIFO or LILO order using priority value
  *                  Sorted by time and type
@@ -18,17 +20,22 @@
 #include "EmptyDataCollectionException.h"
 
 
-template <class ElementType>
+template <class ElementType, class HeapType = BinaryHeap<ElementType>>
 class PriorityQueue {
 
     private:
-        BinaryHeap<ElementType> queueP;
+        HeapType queueP;
         unsigned int elementCount = 0;
 
     public:
         // Description: Constructor
         PriorityQueue();
 
+        // Description: Constructor, the heap takes its memory from anAllocator.
+        // Precondition: HeapType can be constructed from an Allocator (BinaryHeap can).
+        template <class Allocator>
+        explicit PriorityQueue(const Allocator &anAllocator);
+
         // Description: Returns the number of elements in the Priority Queue
         // Postcondition: The Priority Queue is unchanged by this operation.
         // Time Efficiency: O(1)
@@ -42,7 +49,17 @@ class PriorityQueue {
         // Description: Inserts newElement in this Priority Queue and
         //              returns true if successful, otherwise false.
         // Time Efficiency: O(log2 n)
-        bool enqueue(ElementType &newElement);
+        bool enqueue(const ElementType &newElement);
+
+        // Description: Same as enqueue(), but moves newElement into the heap instead of copying it.
+        // Time Efficiency: O(log2 n)
+        bool enqueue(ElementType &&newElement);
+
+        // Description: Constructs a new element from arguments and inserts it in this Priority Queue.
+        //              Returns true if successful, otherwise false.
+        // Time Efficiency: O(log2 n)
+        template <class... Arguments>
+        bool emplace(Arguments &&... arguments);
 
         // Description: Removes (but does not return) the element with the next
         //              "highest" priority value from the Priority Queue.
@@ -58,6 +75,35 @@ class PriorityQueue {
         // Exception: Throws EmptyDataCollectionException if this Priority Queue is empty.
         // Time Efficiency: O(1)
         ElementType &peek() const;
+
+        // Description: Removes the element with the next "highest" priority value from the
+        //              Priority Queue and returns it, moved out rather than copied.
+        // Precondition: This Priority Queue is not empty.
+        // Exception: Throws EmptyDataCollectionException if this Priority Queue is empty.
+        // Time Efficiency: O(log2 n)
+        ElementType pop();
+
+        // Description: Same as dequeue() and peek(), but without checking that this Priority Queue
+        //              is not empty, for callers that have already checked it (the event loop).
+        // Precondition: This Priority Queue is not empty. Otherwise the behaviour is undefined.
+        // Time Efficiency: O(log2 n), and O(1) for peekUnchecked()
+        void dequeueUnchecked();
+        ElementType &peekUnchecked() const;
+
+        // Description: If this Priority Queue is not empty, moves its front element into front,
+        //              removes it and returns true; otherwise returns false.
+        //              Never throws EmptyDataCollectionException.
+        // Time Efficiency: O(log2 n), and O(1) for peekUnchecked()
+        bool tryDequeue(ElementType &front);
+
+        // Description: Makes room for at least newCapacity elements in the heap,
+        //              so it can grow to that many without reallocating.
+        // Precondition: HeapType provides reserve() (BinaryHeap and DaryHeap do).
+        void reserve(unsigned int newCapacity);
+
+        // Description: Returns the number of times the heap reallocated its array.
+        // Precondition: HeapType provides getReallocationCount() (BinaryHeap and DaryHeap do).
+        unsigned long long getReallocationCount() const;
 };
 #include "PriorityQueue.cpp"
 #endif
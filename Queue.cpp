@@ -3,7 +3,12 @@
  *
  * Description: Models arrival and departure events.
  *
+ *              Growth decides when the array is reallocated (see GrowthPolicy.h)
+ *              and Allocator where its memory comes from (e.g. ArenaAllocator).
+ *
  * Class Invariant: FIFO or LILO order
+ *                  Only the elementCount cells from frontindex on (wrapping
+ *                  around) are constructed, the rest of the array is raw memory.
  *
  * Author: Vansh Thakur Rana (vtr)
  *         Agrim Joshi (aja121)
@@ -11,80 +16,103 @@
  */
 
 #include <iostream>
+#include <new>
+#include <utility>
 #include "Queue.h"
+#include "Instrumentation.h"
 
 using std::cout;
 using std::endl;
 
-// Description: Constructor
-template <class ElementType>
-Queue<ElementType>::Queue()
+// Description: Raw memory for newCapacity elements, none of them constructed
+template <class ElementType, class Growth, class Allocator>
+ElementType *Queue<ElementType, Growth, Allocator>::allocate(unsigned int newCapacity) {
+    return std::allocator_traits<Allocator>::allocate(allocator, newCapacity);
+}
+
+// Description: Gives the memory of an array of someCapacity elements back to the allocator
+template <class ElementType, class Growth, class Allocator>
+void Queue<ElementType, Growth, Allocator>::deallocate(ElementType *someElements, unsigned int someCapacity) {
+    std::allocator_traits<Allocator>::deallocate(allocator, someElements, someCapacity);
+}
+
+// Description: Constructor, the array comes from anAllocator.
+template <class ElementType, class Growth, class Allocator>
+Queue<ElementType, Growth, Allocator>::Queue(const Allocator &anAllocator) : allocator(anAllocator)
 {
-    elements = new ElementType[INITIAL_CAPACITY]; // Create a dynamic array on the heap with INITIAL_CAPACITY
+    elements = allocate(INITIAL_CAPACITY); // Create a dynamic array on the heap with INITIAL_CAPACITY
 }
 
 // Description: Destructor
-template <class ElementType>
-Queue<ElementType>::~Queue()
+template <class ElementType, class Growth, class Allocator>
+Queue<ElementType, Growth, Allocator>::~Queue()
 {
-    delete[] elements;
+    for (unsigned int i = 0; i < elementCount; i++)
+        elements[(frontindex + i) % capacity].~ElementType();
+    deallocate(elements, capacity);
 }
 
 // Description: Copy Constructor
-template <class ElementType>
-Queue<ElementType>::Queue(const ElementType &newElement)
+template <class ElementType, class Growth, class Allocator>
+Queue<ElementType, Growth, Allocator>::Queue(const Queue &aQueue)
+    : allocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(aQueue.allocator))
 {
-    capacity = newElement.capacity;         // Set the capacity of new array
-    elementCount = newElement.elementCount; // Set element count of new array
-    frontindex = newElement.frontindex;     // Set front index of new array
-    backindex = newElement.backindex;       // Set back index of new array
-
-    elements = new ElementType[capacity];
-    for (unsigned int i = 0; i < capacity; i++) // Copying elements from into the new array
+    capacity = aQueue.capacity;               // Set the capacity of new array
+    elementCount = aQueue.elementCount;       // Set element count of new array
+    frontindex = aQueue.frontindex;           // Set front index of new array
+    backindex = aQueue.backindex;             // Set back index of new array
+    minimumCapacity = aQueue.minimumCapacity;
+
+    elements = allocate(capacity);
+    for (unsigned int i = 0; i < elementCount; i++) // Copying elements from into the new array
     {
-        elements[i] = newElement.elements[i];
+        unsigned int index = (frontindex + i) % capacity;
+        new (&elements[index]) ElementType(aQueue.elements[index]);
     }
 }
 
 // Description: Overloaded Assignment Operator
-template <class ElementType>
-ElementType& Queue<ElementType>::operator=(const ElementType &newElement) {
-    if (this != &newElement) {                     // Check if the array is not equal to the new array and delete the elements
-        delete[] elements;
-
-        capacity = newElement.capacity;                         // Set the capacity of new array
-        elementCount = newElement.elementCount;                 // Set element count of new array
-        frontindex = newElement.frontindex;                     // Set front index of new array
-        backindex = newElement.backindex;                       // Set back index of new array
-
-        elements = new ElementType[capacity];
-        for (unsigned int i = 0; i < capacity; ++i) {           // Copying elements from into the new array
-            elements[i] = newElement.elements[i];
-        }
+template <class ElementType, class Growth, class Allocator>
+Queue<ElementType, Growth, Allocator>& Queue<ElementType, Growth, Allocator>::operator=(const Queue &aQueue) {
+    if (this != &aQueue) {                         // Check if the array is not equal to the new array and delete the elements
+        Queue copy(aQueue);
+
+        std::swap(elements, copy.elements);
+        std::swap(allocator, copy.allocator);
+        std::swap(capacity, copy.capacity);
+        std::swap(elementCount, copy.elementCount);
+        std::swap(frontindex, copy.frontindex);
+        std::swap(backindex, copy.backindex);
+        std::swap(minimumCapacity, copy.minimumCapacity);
     }
     return *this;
 }
 
 // Description: Resize the array
-template <class ElementType>
-void Queue<ElementType>::resize(unsigned int newCapacity) {
-    ElementType * newElements = new ElementType[newCapacity];               // Create new dynamic array using the new capacity set by enqueue or dequeue
-    for (unsigned int i = 0; i < elementCount; i++) {            
-        newElements[i] = elements[(frontindex + i) % capacity];            // Copying elements into the new array
+//              The elements are moved (not copied) into the new array, front first.
+template <class ElementType, class Growth, class Allocator>
+void Queue<ElementType, Growth, Allocator>::resize(unsigned int newCapacity) {
+    ElementType * newElements = allocate(newCapacity);                      // Create new raw array using the new capacity set by enqueue or dequeue
+    for (unsigned int i = 0; i < elementCount; i++) {
+        ElementType &element = elements[(frontindex + i) % capacity];
+        new (&newElements[i]) ElementType(std::move(element));             // Moving elements into the new array
+        element.~ElementType();
     }
 
-    delete[] elements;                // Clear the old array from the heap memory
+    deallocate(elements, capacity);   // Clear the old array from the heap memory
     elements = newElements;
     frontindex = 0;
-    backindex = elementCount;
+    backindex = elementCount % newCapacity;
     capacity = newCapacity;
+    reallocationCount++;
+    BSIM_COUNT(QUEUE_RESIZES);
 }
 
 // Description: Returns true if this Queue is empty, otherwise false.
 // Postcondition: This Queue is unchanged by this operation.
 // Time Efficiency: O(1)
-template <class ElementType>
-bool Queue<ElementType>::isEmpty() const {
+template <class ElementType, class Growth, class Allocator>
+bool Queue<ElementType, Growth, Allocator>::isEmpty() const {
     return elementCount == 0;
 }
 
@@ -92,35 +120,72 @@ bool Queue<ElementType>::isEmpty() const {
 //              (not necessarily the "back" of this Queue's data structure)
 //              and returns true if successful, otherwise false.
 // Time Efficiency: O(1)
-template <class ElementType>
-bool Queue<ElementType>::enqueue(ElementType &newElement) {
+template <class ElementType, class Growth, class Allocator>
+bool Queue<ElementType, Growth, Allocator>::enqueue(const ElementType &newElement) {
+    return emplace(newElement);
+}
+
+// Description: Same as enqueue(), but moves newElement into this Queue instead of copying it.
+// Time Efficiency: O(1)
+template <class ElementType, class Growth, class Allocator>
+bool Queue<ElementType, Growth, Allocator>::enqueue(ElementType &&newElement) {
+    return emplace(std::move(newElement));
+}
+
+// Description: Constructs a new element from arguments directly at the "back" of this Queue
+//              and returns true if successful, otherwise false.
+// Time Efficiency: O(1)
+template <class ElementType, class Growth, class Allocator>
+template <class... Arguments>
+bool Queue<ElementType, Growth, Allocator>::emplace(Arguments &&... arguments) {
     if (elementCount == capacity) {           // To check if the array needs to be resized to add the new element
-        resize(capacity*2);
+        // The arguments may refer to an element of this Queue, so build the new one before resizing
+        ElementType newElement(std::forward<Arguments>(arguments)...);
+        resize(Growth::grow(capacity));
+        new (&elements[backindex]) ElementType(std::move(newElement));
     }
+    else
+        new (&elements[backindex]) ElementType(std::forward<Arguments>(arguments)...);
 
     elementCount++;
-    elements[backindex] = newElement;
-    backindex = (backindex + 1) % capacity;    
+    BSIM_COUNT(QUEUE_ENQUEUES);
+    backindex = (backindex + 1) % capacity;
     return true;
 }
 
+// Description: Removes (but does not return) the element at the "front" of this Queue,
+//              without checking that there is one.
+template <class ElementType, class Growth, class Allocator>
+void Queue<ElementType, Growth, Allocator>::dequeueUnchecked() {
+    elements[frontindex].~ElementType();
+    elementCount--;
+    BSIM_COUNT(QUEUE_DEQUEUES);
+    frontindex = (frontindex + 1) % capacity;
+
+    unsigned int newCapacity = Growth::shrink(capacity, elementCount, minimumCapacity);
+    if (newCapacity != capacity) {      // To check if the array needs to be shortened after removing the front element
+        resize(newCapacity);
+    }
+    return;
+}
+
 // Description: Removes (but does not return) the element at the "front" of this Queue
 //              (not necessarily the "front" of this Queue's data structure).
 // Precondition: This Queue is not empty.
 // Exception: Throws EmptyDataCollectionException if this Queue is empty.
 // Time Efficiency: O(1)
-template <class ElementType>
-void Queue<ElementType>::dequeue() {
+template <class ElementType, class Growth, class Allocator>
+void Queue<ElementType, Growth, Allocator>::dequeue() {
     if (this->isEmpty())
         throw EmptyDataCollectionException("The Queue is empty.");
-    
-    elementCount--;
-    frontindex = (frontindex + 1) % capacity;
+    dequeueUnchecked();
+}
 
-    if(elementCount < (capacity/4) && ((capacity/2) >= INITIAL_CAPACITY)) {      // To check if the array needs to be shortened after removing the front element
-        resize(capacity/2);
-    }
-    return;
+// Description: Returns (but does not remove) the element at the "front" of this Queue,
+//              without checking that there is one.
+template <class ElementType, class Growth, class Allocator>
+ElementType &Queue<ElementType, Growth, Allocator>::peekUnchecked() const {
+    return elements[frontindex];
 }
 
 // Description: Returns (but does not remove) the element at the "front" of this Queue
@@ -129,10 +194,60 @@ void Queue<ElementType>::dequeue() {
 // Postcondition: This Queue is unchanged by this operation.
 // Exception: Throws EmptyDataCollectionException if this Queue is empty.
 // Time Efficiency: O(1)
-template <class ElementType>
-ElementType &Queue<ElementType>::peek() const {
+template <class ElementType, class Growth, class Allocator>
+ElementType &Queue<ElementType, Growth, Allocator>::peek() const {
     if(this->isEmpty())
         throw EmptyDataCollectionException("The Queue is empty.");
+    return peekUnchecked();
+}
 
-    return elements[frontindex];
+// Description: Removes the element at the "front" of this Queue and returns it,
+//              moved out rather than copied.
+// Precondition: This Queue is not empty.
+// Exception: Throws EmptyDataCollectionException if this Queue is empty.
+// Time Efficiency: O(1)
+template <class ElementType, class Growth, class Allocator>
+ElementType Queue<ElementType, Growth, Allocator>::pop() {
+    if (this->isEmpty())
+        throw EmptyDataCollectionException("The Queue is empty.");
+    ElementType front(std::move(peekUnchecked()));
+    dequeueUnchecked();
+    return front;
+}
+
+// Description: If this Queue is not empty, moves its front element into front,
+//              removes it and returns true; otherwise returns false.
+template <class ElementType, class Growth, class Allocator>
+bool Queue<ElementType, Growth, Allocator>::tryDequeue(ElementType &front) {
+    if (isEmpty())
+        return false;
+    front = std::move(peekUnchecked());
+    dequeueUnchecked();
+    return true;
+}
+
+// Description: Makes room for at least newCapacity elements, so the Queue can
+//              grow to that many without reallocating, and keeps at least that
+//              much room from then on.
+// Time Efficiency: O(n) if the array is reallocated, otherwise O(1)
+template <class ElementType, class Growth, class Allocator>
+void Queue<ElementType, Growth, Allocator>::reserve(unsigned int newCapacity) {
+    if (newCapacity > minimumCapacity)
+        minimumCapacity = newCapacity;
+    if (newCapacity > capacity)
+        resize(newCapacity);
+}
+
+// Description: Returns the number of elements the Queue holds without reallocating.
+// Time Efficiency: O(1)
+template <class ElementType, class Growth, class Allocator>
+unsigned int Queue<ElementType, Growth, Allocator>::getCapacity() const {
+    return capacity;
+}
+
+// Description: Returns the number of times the array was reallocated (grown or shrunk).
+// Time Efficiency: O(1)
+template <class ElementType, class Growth, class Allocator>
+unsigned long long Queue<ElementType, Growth, Allocator>::getReallocationCount() const {
+    return reallocationCount;
 }
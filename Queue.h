@@ -3,7 +3,12 @@
  *
  * Description: Models arrival and departure events.
  *
+ *              Growth decides when the array is reallocated (see GrowthPolicy.h)
+ *              and Allocator where its memory comes from (e.g. ArenaAllocator).
+ *
  * Class Invariant: FIFO or LILO order
+ *                  Only the elementCount cells from frontindex on (wrapping
+ *                  around) are constructed, the rest of the array is raw memory.
  *
  * Author: Vansh Thakur Rana (vtr)
  *         Agrim Joshi (aja121)
@@ -13,36 +18,43 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include <memory>
 #include"Event.h"
+#include "GrowthPolicy.h"
 #include "EmptyDataCollectionException.h"
 
-template <class ElementType>
+template <class ElementType, class Growth = DefaultGrowth, class Allocator = std::allocator<ElementType>>
 class Queue {
 
     private:
         static unsigned int const INITIAL_CAPACITY = 6; // Constant INITIAL_CAPACITY
         ElementType *elements;
+        Allocator allocator;                      // Where the array comes from
 
         unsigned int elementCount = 0;            // Number of elements in the Queue - if you need it!
         unsigned int capacity = INITIAL_CAPACITY; // Actual capacity of the data structure (number of cells in the array)
         unsigned int frontindex = 0;              // Index of front element (next dequeued/peeked element)
         unsigned int backindex = 0;               // Index of where the next element will be enqueued
+        unsigned int minimumCapacity = INITIAL_CAPACITY; // The array never shrinks below this (see reserve())
+        unsigned long long reallocationCount = 0; // Number of times the array was reallocated
 
+        ElementType *allocate(unsigned int newCapacity); // Raw memory for newCapacity elements
+        void deallocate(ElementType *someElements, unsigned int someCapacity); // Gives the memory back
         void resize(unsigned int newCapacity); // To resize the array
 
     public:
 
-        // Description: Constructor
-        Queue();
+        // Description: Constructor, the array comes from anAllocator.
+        explicit Queue(const Allocator &anAllocator = Allocator());
 
         // Description: Destructor
         ~Queue();
 
         // Description: Copy Constructor
-        Queue(const ElementType &newElement);
+        Queue(const Queue &aQueue);
 
         // Description: Overloaded Assignment operator
-        ElementType & operator=(const ElementType &newElement);
+        Queue & operator=(const Queue &aQueue);
 
         // Description: Constructor
         // Time Efficiency: O(1)
@@ -52,7 +64,17 @@ class Queue {
         //              (not necessarily the "back" of this Queue's data structure)
         //              and returns true if successful, otherwise false.
         // Time Efficiency: O(1)
-        bool enqueue(ElementType &newElement);
+        bool enqueue(const ElementType &newElement);
+
+        // Description: Same as enqueue(), but moves newElement into this Queue instead of copying it.
+        // Time Efficiency: O(1)
+        bool enqueue(ElementType &&newElement);
+
+        // Description: Constructs a new element from arguments directly at the "back" of this Queue
+        //              and returns true if successful, otherwise false.
+        // Time Efficiency: O(1)
+        template <class... Arguments>
+        bool emplace(Arguments &&... arguments);
 
         // Description: Removes (but does not return) the element at the "front" of this Queue
         //              (not necessarily the "front" of this Queue's data structure).
@@ -68,6 +90,40 @@ class Queue {
         // Exception: Throws EmptyDataCollectionException if this Queue is empty.
         // Time Efficiency: O(1)
         ElementType &peek() const;
+
+        // Description: Removes the element at the "front" of this Queue and returns it,
+        //              moved out rather than copied.
+        // Precondition: This Queue is not empty.
+        // Exception: Throws EmptyDataCollectionException if this Queue is empty.
+        // Time Efficiency: O(1)
+        ElementType pop();
+
+        // Description: Same as dequeue() and peek(), but without checking that this Queue
+        //              is not empty, for callers that have already checked it (the event loop).
+        // Precondition: This Queue is not empty. Otherwise the behaviour is undefined.
+        // Time Efficiency: O(1)
+        void dequeueUnchecked();
+        ElementType &peekUnchecked() const;
+
+        // Description: If this Queue is not empty, moves its front element into front,
+        //              removes it and returns true; otherwise returns false.
+        //              Never throws EmptyDataCollectionException.
+        // Time Efficiency: O(1)
+        bool tryDequeue(ElementType &front);
+
+        // Description: Makes room for at least newCapacity elements, so the Queue can
+        //              grow to that many without reallocating, and keeps at least that
+        //              much room from then on.
+        // Time Efficiency: O(n) if the array is reallocated, otherwise O(1)
+        void reserve(unsigned int newCapacity);
+
+        // Description: Returns the number of elements the Queue holds without reallocating.
+        // Time Efficiency: O(1)
+        unsigned int getCapacity() const;
+
+        // Description: Returns the number of times the array was reallocated (grown or shrunk).
+        // Time Efficiency: O(1)
+        unsigned long long getReallocationCount() const;
 };
 #include "Queue.cpp"
 #endif
@@ -0,0 +1,149 @@
+/*
+ * ShardedSimulation.cpp
+ *
+ * Description: Simulates every branch of a region separately, on a
+ *              WorkStealingPool, and merges the results (see ShardedSimulation.h).
+ *
+ * Class Invariant: Branches are kept in increasing order of their id.
+ */
+
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include "ShardedSimulation.h"
+#include "TraceLog.h"
+#include "WorkStealingPool.h"
+
+using std::endl;
+using std::setw;
+
+
+// Description: Constructor
+ShardedSimulation::Branch::Branch(int anId, std::vector<Event> &&someArrivals, unsigned int numberOfTellers)
+    : id(anId), arrivals(std::move(someArrivals)), statistics(numberOfTellers) { }
+
+
+// Description: Constructor, every branch has numberOfTellers tellers.
+ShardedSimulation::ShardedSimulation(unsigned int aNumberOfTellers, Simulation::LineDiscipline aDiscipline,
+                                     Simulation::Scheduler aScheduler, size_t anArenaSize)
+    : numberOfTellers(aNumberOfTellers), discipline(aDiscipline), scheduler(aScheduler),
+      arenaSize(anArenaSize), regional(aNumberOfTellers) { }
+
+// Description: Reads the tagged trace of input and partitions it by branch.
+void ShardedSimulation::partition(FastTextArrivalReader &input, bool sortEachBranch) {
+    std::map<int, std::vector<Event>> arrivalsOf;
+    int branch;
+    Event newEvent;
+    while (input.nextTagged(branch, newEvent)) {
+        arrivalsOf[branch].push_back(newEvent);
+        arrivalCount++;
+    }
+
+    for (auto &entry : arrivalsOf) {
+        if (sortEachBranch)
+            std::stable_sort(entry.second.begin(), entry.second.end(),
+                             [](const Event &lhs, const Event &rhs) { return lhs.getTime() < rhs.getTime(); });
+        branches.emplace_back(entry.first, std::move(entry.second), numberOfTellers);
+    }
+}
+
+// Description: Simulates branches[index], taking memory from arena.
+//              The arena is reset once the simulation is gone.
+void ShardedSimulation::simulate(unsigned int index, MonotonicArena &arena) {
+    Branch &aBranch = branches[index];
+    try {
+        std::unique_ptr<Simulation> simulation(Simulation::create(numberOfTellers, discipline, scheduler, &arena));
+        BufferedArrivalReader reader(aBranch.arrivals);
+        std::ostringstream messages;
+        TraceLog traceLog(messages, TraceLog::SUMMARY);
+
+        simulation->run(reader, traceLog);
+        aBranch.customerCount = simulation->getCustomerCount();
+        aBranch.totalWait = simulation->getTotalWait();
+        aBranch.statistics = simulation->getStatistics();
+    }
+    catch (std::exception &anException) {
+        aBranch.error = anException.what();
+    }
+    arena.reset();
+}
+
+// Description: Simulates every branch, using up to numberOfThreads threads,
+//              then merges their statistics.
+//              The branches are submitted largest first, so the longest ones start
+//              early and the short ones fill in at the end.
+void ShardedSimulation::run(unsigned int numberOfThreads) {
+    if (numberOfThreads > branches.size())
+        numberOfThreads = branches.size();
+    WorkStealingPool pool(numberOfThreads);
+    std::vector<std::unique_ptr<MonotonicArena>> arenas;
+    for (unsigned int i = 0; i < pool.getWorkerCount(); i++)
+        arenas.emplace_back(new MonotonicArena(arenaSize));
+
+    std::vector<unsigned int> order(branches.size());
+    for (unsigned int i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](unsigned int lhs, unsigned int rhs) {
+        return branches[lhs].arrivals.getElementCount() > branches[rhs].arrivals.getElementCount();
+    });
+    for (unsigned int i = 0; i < order.size(); i++) {
+        unsigned int index = order[i];
+        pool.submit([this, index, &arenas](unsigned int worker) { simulate(index, *arenas[worker]); });
+    }
+    pool.run();
+
+    // Merge in branch order, whichever thread simulated which branch
+    for (unsigned int i = 0; i < branches.size(); i++) {
+        const Branch &aBranch = branches[i];
+        if (!aBranch.error.empty())
+            continue;
+        regional.merge(aBranch.statistics);
+        customerCount += aBranch.customerCount;
+        totalWait += aBranch.totalWait;
+    }
+}
+
+// Description: Returns the branches with their results.
+const std::vector<ShardedSimulation::Branch> & ShardedSimulation::getBranches() const {
+    return branches;
+}
+
+// Description: Returns the number of arrivals over all branches.
+size_t ShardedSimulation::getArrivalCount() const {
+    return arrivalCount;
+}
+
+// Description: Returns the number of customers over all branches that succeeded.
+long long ShardedSimulation::getCustomerCount() const {
+    return customerCount;
+}
+
+// Description: Returns the sum of the waits over all branches that succeeded.
+long long ShardedSimulation::getTotalWait() const {
+    return totalWait;
+}
+
+// Description: Returns the merged statistics of the branches that succeeded.
+const SimulationStatistics & ShardedSimulation::getStatistics() const {
+    return regional;
+}
+
+// Description: Prints one line per branch.
+void ShardedSimulation::printTable(std::ostream &output) const {
+    output << "    Branch  Customers  Average wait  p99 wait  Utilization" << endl;
+    for (unsigned int i = 0; i < branches.size(); i++) {
+        const Branch &aBranch = branches[i];
+        output << setw(10) << aBranch.id << "  ";
+        if (!aBranch.error.empty())
+            output << "error: " << aBranch.error << endl;
+        else
+            output << setw(9) << aBranch.customerCount << "  " << setw(12)
+                   << float(aBranch.totalWait)/float(aBranch.customerCount) << "  " << setw(8)
+                   << aBranch.statistics.getWaitQuantiles().quantile(0.99) << "  " << setw(11)
+                   << aBranch.statistics.getUtilization() << endl;
+    }
+}
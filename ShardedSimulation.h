@@ -0,0 +1,100 @@
+/*
+ * ShardedSimulation.h
+ *
+ * Description: Simulates every branch of a region separately and merges the
+ *              results. The input is a trace tagged with the branch of every
+ *              arrival ("branch time length" lines); it is partitioned by branch,
+ *              and each branch runs through its own Simulation (event queue,
+ *              lines, tellers) on a WorkStealingPool, largest branch first.
+ *              Branches share nothing while they run. Their statistics are then
+ *              merged, in branch order, into the regional statistics, so the
+ *              summary does not depend on the number of threads.
+ *              The regional line lengths and utilization are those of a branch,
+ *              averaged over the branches weighted by the time each was open.
+ *
+ * Class Invariant: Branches are kept in increasing order of their id.
+ */
+
+#ifndef SHARDED_SIMULATION_H
+#define SHARDED_SIMULATION_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Event.h"
+#include "ArrivalReader.h"
+#include "Simulation.h"
+#include "Statistics.h"
+
+class ShardedSimulation {
+
+    public:
+        // Arrivals and results of one branch
+        struct Branch {
+            int id;
+            ArrivalBuffer arrivals;
+            long long customerCount = 0;
+            long long totalWait = 0;
+            SimulationStatistics statistics;
+            std::string error = "";        // Why the branch failed, empty if it succeeded
+
+            // Description: Constructor
+            Branch(int anId, std::vector<Event> &&someArrivals, unsigned int numberOfTellers);
+        };
+
+    private:
+        unsigned int numberOfTellers;      // Of every branch
+        Simulation::LineDiscipline discipline;
+        Simulation::Scheduler scheduler;
+        size_t arenaSize;                  // Initial size of each worker's arena
+        std::vector<Branch> branches;
+        size_t arrivalCount = 0;
+        SimulationStatistics regional;     // Merged statistics of the branches that succeeded
+        long long customerCount = 0;
+        long long totalWait = 0;
+
+        // Description: Simulates branches[index], taking memory from arena.
+        void simulate(unsigned int index, MonotonicArena &arena);
+
+    public:
+        static size_t const DEFAULT_ARENA_SIZE = 1 << 20;   // Bytes
+
+        // Description: Constructor, every branch has numberOfTellers tellers.
+        ShardedSimulation(unsigned int aNumberOfTellers, Simulation::LineDiscipline aDiscipline,
+                          Simulation::Scheduler aScheduler = Simulation::BINARY_HEAP,
+                          size_t anArenaSize = DEFAULT_ARENA_SIZE);
+
+        // Description: Reads the tagged trace of input and partitions it by branch.
+        //              Arrivals keep their input order within a branch, unless sortEachBranch
+        //              is set: then each branch is sorted by time, keeping the input order
+        //              of arrivals with equal times.
+        // Exceptions: Throws InputFormatException if a line is malformed
+        //             and runtime_error if the input cannot be read.
+        // Time Efficiency: O(n), or O(n log n) with sortEachBranch
+        void partition(FastTextArrivalReader &input, bool sortEachBranch = false);
+
+        // Description: Simulates every branch, using up to numberOfThreads threads,
+        //              then merges their statistics.
+        //              A branch that fails (e.g. unsorted arrivals) records its error
+        //              and is left out of the regional statistics.
+        void run(unsigned int numberOfThreads);
+
+        // Description: Returns the branches with their results.
+        const std::vector<Branch> &getBranches() const;
+
+        // Description: Returns the number of arrivals over all branches.
+        size_t getArrivalCount() const;
+
+        // Description: Returns the number of customers over all branches that succeeded.
+        long long getCustomerCount() const;
+
+        // Description: Returns the sum of the waits over all branches that succeeded.
+        long long getTotalWait() const;
+
+        // Description: Returns the merged statistics of the branches that succeeded.
+        const SimulationStatistics &getStatistics() const;
+
+        // Description: Prints one line per branch.
+        void printTable(std::ostream &output) const;
+};
+#endif
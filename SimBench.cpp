@@ -0,0 +1,244 @@
+/*
+ * SimBench.cpp
+ *
+ * Description: Benchmarks the whole simulator on synthetic workloads (see
+ *              SyntheticArrivals.h): for every arrival pattern and kind of
+ *              transaction length asked for, it generates a text trace, then times
+ *                  ingest  parsing the trace into memory (block parser),
+ *                  loop    the event loop without any output,
+ *                  output  logging every event, measured as a run with the full
+ *                          event log (written to /dev/null) minus the loop time,
+ *              and reports events per second and ns per event (an arrival and a
+ *              departure per customer) for the loop, plus the peak resident set size
+ *              of the benchmark so far.
+ *              One result per line, as JSON (default) or CSV, so results can be
+ *              collected and compared across releases.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "ArrivalReader.h"
+#include "SyntheticArrivals.h"
+#include "Simulation.h"
+#include "TraceLog.h"
+
+using namespace std;
+
+// One line of results
+struct Result {
+    SyntheticArrivalReader::Workload workload;
+    const char *scheduler;
+    bool eventDriven;                 // The event driven engine even for a single teller
+    unsigned int numberOfTellers;
+    size_t arrivals;
+    long long events;
+    double generateTime;
+    double ingestTime;
+    double loopTime;
+    double outputTime;
+    double averageWait;
+    long peakResidentKiB;
+};
+
+// Returns the peak resident set size of this process so far, in KiB.
+long peakResidentKiB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Seconds since start
+double since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Simulates arrivals, logging events to output in mode. Returns the simulation.
+unique_ptr<Simulation> simulate(const ArrivalBuffer &arrivals, unsigned int numberOfTellers,
+                                Simulation::Scheduler scheduler, bool eventDriven, ostream &output, TraceLog::Mode mode) {
+    unique_ptr<Simulation> simulation(eventDriven
+        ? Simulation::createEventDriven(numberOfTellers, Simulation::SHARED_LINE, scheduler)
+        : Simulation::create(numberOfTellers, Simulation::SHARED_LINE, scheduler));
+    BufferedArrivalReader reader(arrivals);
+    TraceLog traceLog(output, mode);
+    simulation->run(reader, traceLog);
+    return simulation;
+}
+
+// Generates the workload, then times ingestion, the event loop and the output.
+Result benchmark(const SyntheticArrivalReader::Workload &workload, unsigned int numberOfTellers,
+                 Simulation::Scheduler scheduler, const char *schedulerName, bool eventDriven) {
+    Result result;
+    result.workload = workload;
+    result.scheduler = schedulerName;
+    result.eventDriven = eventDriven;
+    result.numberOfTellers = numberOfTellers;
+
+    // The text trace goes to an anonymous temporary file
+    FILE *trace = tmpfile();
+    if (trace == nullptr)
+        throw runtime_error("could not create a temporary file");
+    auto start = chrono::steady_clock::now();
+    {
+        SyntheticArrivalReader generator(workload);
+        Event newEvent;
+        while (generator.next(newEvent))
+            fprintf(trace, "%d %d\n", newEvent.getTime(), newEvent.getLength());
+    }
+    bool written = fflush(trace) == 0;
+    result.generateTime = since(start);
+    if (!written || lseek(fileno(trace), 0, SEEK_SET) != 0) {
+        fclose(trace);
+        throw runtime_error("could not write the temporary trace");
+    }
+
+    start = chrono::steady_clock::now();
+    FastTextArrivalReader textReader(fileno(trace));
+    ArrivalBuffer arrivals(textReader);
+    result.ingestTime = since(start);
+    fclose(trace);
+    result.arrivals = arrivals.getElementCount();
+
+    ostringstream unused;
+    start = chrono::steady_clock::now();
+    unique_ptr<Simulation> simulation = simulate(arrivals, numberOfTellers, scheduler, eventDriven, unused, TraceLog::SUMMARY);
+    result.loopTime = since(start);
+    result.events = 2 * simulation->getCustomerCount();
+    result.averageWait = simulation->getStatistics().getWait().getMean();
+    simulation.reset();
+
+    ofstream devNull("/dev/null");
+    start = chrono::steady_clock::now();
+    simulate(arrivals, numberOfTellers, scheduler, eventDriven, devNull, TraceLog::FULL);
+    result.outputTime = since(start) - result.loopTime;
+    if (result.outputTime < 0)
+        result.outputTime = 0;
+
+    result.peakResidentKiB = peakResidentKiB();
+    return result;
+}
+
+// Prints the names of the fields, for CSV
+void printHeader(ostream &output) {
+    output << "pattern,service,arrivals,events,scheduler,engine,tellers,generate_s,ingest_s,loop_s,output_s,"
+              "events_per_s,ns_per_event,ingest_ns_per_arrival,average_wait,peak_rss_kib" << endl;
+}
+
+// Prints one result, as a JSON object on one line or as a CSV line
+void printResult(ostream &output, const Result &result, bool json) {
+    double eventsPerSecond = result.loopTime > 0 ? result.events / result.loopTime : 0;
+    double nsPerEvent = result.events > 0 ? 1e9 * result.loopTime / result.events : 0;
+    double ingestNs = result.arrivals > 0 ? 1e9 * result.ingestTime / result.arrivals : 0;
+    const char *pattern = SyntheticArrivalReader::nameOf(result.workload.pattern);
+    const char *service = SyntheticArrivalReader::nameOf(result.workload.service);
+    const char *engine = result.eventDriven ? "event" : "auto";
+
+    if (json)
+        output << "{\"pattern\":\"" << pattern << "\",\"service\":\"" << service
+               << "\",\"arrivals\":" << result.arrivals << ",\"events\":" << result.events
+               << ",\"scheduler\":\"" << result.scheduler << "\",\"engine\":\"" << engine
+               << "\",\"tellers\":" << result.numberOfTellers
+               << ",\"generate_s\":" << result.generateTime << ",\"ingest_s\":" << result.ingestTime
+               << ",\"loop_s\":" << result.loopTime << ",\"output_s\":" << result.outputTime
+               << ",\"events_per_s\":" << eventsPerSecond << ",\"ns_per_event\":" << nsPerEvent
+               << ",\"ingest_ns_per_arrival\":" << ingestNs << ",\"average_wait\":" << result.averageWait
+               << ",\"peak_rss_kib\":" << result.peakResidentKiB << "}" << endl;
+    else
+        output << pattern << "," << service << "," << result.arrivals << "," << result.events << ","
+               << result.scheduler << "," << engine << "," << result.numberOfTellers << "," << result.generateTime << ","
+               << result.ingestTime << "," << result.loopTime << "," << result.outputTime << ","
+               << eventsPerSecond << "," << nsPerEvent << "," << ingestNs << "," << result.averageWait << ","
+               << result.peakResidentKiB << endl;
+}
+
+// Prints how to call the benchmark
+void printUsage(const char *program) {
+    cerr << "Usage: " << program << " [options]" << endl;
+    cerr << "    --pattern P       poisson, bursty or diurnal (default: each of them)" << endl;
+    cerr << "    --service S       exponential or pareto transaction lengths (default: each of them)" << endl;
+    cerr << "    --arrivals N      Arrivals per workload (default 1000000)" << endl;
+    cerr << "    --gap X           Mean time between arrivals (default 10)" << endl;
+    cerr << "    --length X        Mean transaction length (default 8)" << endl;
+    cerr << "    --tellers N       Number of tellers, sharing one line (default 1)" << endl;
+    cerr << "    --scheduler KIND  binary (default), 4ary, calendar or soa (see bsim)" << endl;
+    cerr << "    --engine KIND     auto (default: no event queue for a single teller) or event (see bsim)" << endl;
+    cerr << "    --seed N          Seed of the generator (default 1)" << endl;
+    cerr << "    --format F        json (one object per line, default) or csv" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    SyntheticArrivalReader::Workload workload;
+    vector<SyntheticArrivalReader::Pattern> patterns;
+    vector<SyntheticArrivalReader::Service> services;
+    unsigned int numberOfTellers = 1;
+    Simulation::Scheduler scheduler = Simulation::BINARY_HEAP;
+    const char *schedulerName = "binary";
+    bool eventDriven = false;
+    bool json = true;
+
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        string value = i + 1 < argc ? argv[i + 1] : "";
+        SyntheticArrivalReader::Pattern pattern;
+        SyntheticArrivalReader::Service service;
+        if (option == "--pattern" && SyntheticArrivalReader::parse(value, pattern))
+            patterns.push_back(pattern), i++;
+        else if (option == "--service" && SyntheticArrivalReader::parse(value, service))
+            services.push_back(service), i++;
+        else if (option == "--arrivals" && atoll(value.c_str()) > 0)
+            workload.count = atoll(argv[++i]);
+        else if (option == "--gap" && atof(value.c_str()) > 0)
+            workload.meanGap = atof(argv[++i]);
+        else if (option == "--length" && atof(value.c_str()) > 0)
+            workload.meanLength = atof(argv[++i]);
+        else if (option == "--tellers" && atoi(value.c_str()) > 0)
+            numberOfTellers = atoi(argv[++i]);
+        else if (option == "--seed" && !value.empty())
+            workload.seed = strtoull(argv[++i], nullptr, 10);
+        else if (option == "--scheduler" && value == "binary")
+            scheduler = Simulation::BINARY_HEAP, schedulerName = argv[++i];
+        else if (option == "--scheduler" && value == "4ary")
+            scheduler = Simulation::QUATERNARY_HEAP, schedulerName = argv[++i];
+        else if (option == "--scheduler" && value == "calendar")
+            scheduler = Simulation::CALENDAR_QUEUE, schedulerName = argv[++i];
+        else if (option == "--scheduler" && value == "soa")
+            scheduler = Simulation::STRUCTURE_OF_ARRAYS, schedulerName = argv[++i];
+        else if (option == "--engine" && (value == "auto" || value == "event"))
+            eventDriven = (value == "event"), i++;
+        else if (option == "--format" && (value == "json" || value == "csv"))
+            json = (value == "json"), i++;
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (patterns.empty())
+        patterns = { SyntheticArrivalReader::POISSON, SyntheticArrivalReader::BURSTY, SyntheticArrivalReader::DIURNAL };
+    if (services.empty())
+        services = { SyntheticArrivalReader::EXPONENTIAL, SyntheticArrivalReader::PARETO };
+
+    try {
+        if (!json)
+            printHeader(cout);
+        for (unsigned int p = 0; p < patterns.size(); p++)
+            for (unsigned int s = 0; s < services.size(); s++) {
+                workload.pattern = patterns[p];
+                workload.service = services[s];
+                printResult(cout, benchmark(workload, numberOfTellers, scheduler, schedulerName, eventDriven), json);
+            }
+    }
+    catch (runtime_error &anException) {
+        cerr << anException.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,277 @@
+/*
+ * Simulation.cpp
+ *
+ * Description: Event driven simulation of a bank branch with one or more tellers.
+ *              Customers either wait in one line shared by all tellers, or each
+ *              teller has its own line and arriving customers join the line of
+ *              the teller with the fewest customers (join-shortest-queue).
+ *
+ *              The engine itself is EventSimulation, instantiated for each kind
+ *              of event queue; create() picks one at run time. For a single teller
+ *              create() picks LindleySimulation instead, which gives the same
+ *              results without an event queue.
+ *
+ *              Runs driven by the caller: the arrivals given are kept in a line and
+ *              merged here with the departures the engine schedules; at equal times
+ *              the arrival comes first, as in the event queue of run().
+ *
+ *              Checkpoints: the state common to both engines (clock, counts,
+ *              statistics, teller loads) is saved here, the events and lines by
+ *              the engine (see Checkpoint.h).
+ *
+ * Class Invariant: A customer only waits in a line while their teller is busy.
+ */
+
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include "Simulation.h"
+#include "EventSimulation.h"
+#include "LindleySimulation.h"
+#include "BinaryHeap.h"
+#include "DaryHeap.h"
+#include "CalendarQueue.h"
+#include "EventHeap.h"
+#include "EventLine.h"
+#include "Instrumentation.h"
+
+// Where begin() without a log logs: nowhere, and nothing is buffered in SUMMARY mode
+static std::ostream discardedOutput(nullptr);
+static TraceLog quietLog(discardedOutput, TraceLog::SUMMARY);
+
+// Description: Constructor
+Simulation::Simulation(unsigned int numberOfTellers, LineDiscipline aDiscipline)
+    : discipline(aDiscipline), numberOfLines(aDiscipline == SHARED_LINE ? 1 : numberOfTellers),
+      tellers(numberOfTellers), statistics(numberOfTellers) { }
+
+// Description: Creates a simulation whose event queue is kept by scheduler,
+//              or the analytic LindleySimulation if there is a single teller.
+Simulation * Simulation::create(unsigned int numberOfTellers, LineDiscipline aDiscipline, Scheduler scheduler,
+                                MonotonicArena *arena) {
+    if (numberOfTellers == 1)
+        return new LindleySimulation(aDiscipline);
+    return createEventDriven(numberOfTellers, aDiscipline, scheduler, arena);
+}
+
+// Description: Same as create(), but always the event driven engine.
+Simulation * Simulation::createEventDriven(unsigned int numberOfTellers, LineDiscipline aDiscipline,
+                                           Scheduler scheduler, MonotonicArena *arena) {
+    typedef BinaryHeap<Event, HeapOrder<Event>, NeverShrink, ArenaAllocator<Event>> ArenaHeap;
+    typedef Queue<Event, NeverShrink, ArenaAllocator<Event>> ArenaLine;
+    if (arena != nullptr && scheduler == BINARY_HEAP)
+        return new EventSimulation<ArenaHeap, ArenaLine>(numberOfTellers, aDiscipline, ArenaAllocator<Event>(arena));
+
+    switch (scheduler) {
+        case QUATERNARY_HEAP:
+            return new EventSimulation<QuaternaryHeap<Event>>(numberOfTellers, aDiscipline);
+        case CALENDAR_QUEUE:
+            return new EventSimulation<CalendarQueue<Event>>(numberOfTellers, aDiscipline);
+        case STRUCTURE_OF_ARRAYS:
+            return new EventSimulation<EventHeap<>, EventLine<LazyShrink>>(numberOfTellers, aDiscipline);
+        default:
+            return new EventSimulation<BinaryHeap<Event>>(numberOfTellers, aDiscipline);
+    }
+}
+
+// Description: Destructor
+Simulation::~Simulation() { }
+
+// Description: Returns the index of the line the customers of teller wait in.
+unsigned int Simulation::lineIndexOf(unsigned int teller) const {
+    return discipline == SHARED_LINE ? 0 : teller;
+}
+
+// Description: Reads the next arrival of arrivals into newArrivalEvent, false at the end of them.
+bool Simulation::readArrival(ArrivalReader &arrivals, Event &newArrivalEvent) {
+    BSIM_PHASE(PARSE);
+    if (!arrivals.next(newArrivalEvent))
+        return false;
+    acceptArrival(newArrivalEvent);
+    return true;
+}
+
+// Description: Checks that newArrivalEvent does not arrive before the arrival
+//              before it, and counts it.
+void Simulation::acceptArrival(const Event &newArrivalEvent) {
+    if (newArrivalEvent.getTime() < lastArrivalTime)
+        throw std::runtime_error("Input is not sorted by arrival time ("
+                            + std::to_string(newArrivalEvent.getTime()) + " after "
+                            + std::to_string(lastArrivalTime) + "); rerun with --unsorted.");
+    lastArrivalTime = newArrivalEvent.getTime();
+    arrivalsRead++;
+}
+
+// Description: Takes a checkpoint if one is due. Returns true if the run is to stop.
+bool Simulation::checkpointIfDue() {
+    if (checkpoints == nullptr || !checkpoints->isDue(customerCount))
+        return false;
+    return checkpoints->write(*this);
+}
+
+// Description: Makes run() also report its metrics interval by interval to someIntervals.
+void Simulation::setIntervalMetrics(IntervalMetrics *someIntervals) {
+    intervals = someIntervals;
+}
+
+// Description: Lets run() use up to aNumberOfThreads threads where the engine can.
+void Simulation::setThreadCount(unsigned int aNumberOfThreads) {
+    numberOfThreads = aNumberOfThreads == 0 ? 1 : aNumberOfThreads;
+}
+
+// Description: Makes run() take a checkpoint with someCheckpoints whenever one is due.
+void Simulation::setCheckpointer(Checkpointer *someCheckpoints) {
+    checkpoints = someCheckpoints;
+}
+
+// Description: Writes the state of the run in progress to aCheckpoint:
+//              the state common to both engines, then that of the engine.
+void Simulation::save(CheckpointWriter &aCheckpoint) {
+    aCheckpoint.putUInt32(tellers.getNumberOfTellers());
+    aCheckpoint.putUInt32(discipline);
+    aCheckpoint.putInt64(customerCount);
+    aCheckpoint.putInt64(arrivalsRead);
+    saveState(aCheckpoint);
+}
+
+// Description: Writes the state the rest of the run depends on, but not the
+//              number of customers, to aCheckpoint.
+void Simulation::saveState(CheckpointWriter &aCheckpoint) {
+    aCheckpoint.putInt32(currentTime);
+    aCheckpoint.putInt32(lastArrivalTime);
+    statistics.save(aCheckpoint);
+    for (unsigned int teller = 0; teller < tellers.getNumberOfTellers(); teller++)
+        aCheckpoint.putUInt32(tellers.getLoad(teller));
+    saveEngine(aCheckpoint);
+}
+
+// Description: Restores the state written by saveState() of a run that had
+//              processed customers arrivals.
+void Simulation::restoreState(CheckpointReader &aCheckpoint, long long customers) {
+    customerCount = customers;
+    arrivalsRead = customers;
+    currentTime = aCheckpoint.getInt32();
+    lastArrivalTime = aCheckpoint.getInt32();
+    statistics.restore(aCheckpoint);
+    for (unsigned int teller = 0; teller < tellers.getNumberOfTellers(); teller++)
+        for (uint32_t load = aCheckpoint.getUInt32(); load > 0; load--)
+            tellers.addCustomer(teller);
+    restoreEngine(aCheckpoint);
+}
+
+// Description: Returns the statistics so far and starts them over from now.
+SimulationStatistics Simulation::splitStatistics() {
+    return statistics.split();
+}
+
+// Description: Restores the state of the run checkpointed in fileName and skips
+//              the arrivals it had read, so that run() goes on from there.
+void Simulation::resume(const std::string &fileName, ArrivalReader &arrivals) {
+    CheckpointReader checkpoint(fileName);
+    if (checkpoint.getUInt32() != tellers.getNumberOfTellers() || checkpoint.getUInt32() != uint32_t(discipline))
+        throw std::runtime_error("checkpoint " + fileName + " is for another number of tellers or line discipline");
+    long long customers = checkpoint.getInt64();
+    long long read = checkpoint.getInt64();
+    restoreState(checkpoint, customers);
+    arrivalsRead = read;
+    checkpoint.finish();
+
+    BSIM_PHASE(PARSE);
+    if (arrivals.skip(arrivalsRead) != (unsigned long long)arrivalsRead)
+        throw std::runtime_error("the input ends before the " + std::to_string(arrivalsRead)
+                                 + " arrivals checkpoint " + fileName + " had read");
+}
+
+// Description: Returns true if the run stopped at a checkpoint, before the end of arrivals.
+bool Simulation::isStopped() const {
+    return checkpoints != nullptr && checkpoints->isStopped();
+}
+
+// Description: Begins a run driven by the caller, logging events nowhere.
+void Simulation::begin() {
+    begin(quietLog);
+}
+
+// Description: Begins a run driven by the caller, logging events to aTraceLog.
+void Simulation::begin(TraceLog &aTraceLog) {
+    traceLog = &aTraceLog;
+}
+
+// Description: Gives the run the next arrival.
+void Simulation::addArrival(const Event &newArrivalEvent) {
+    if (arrivalsEnded)
+        throw std::runtime_error("arrival at " + std::to_string(newArrivalEvent.getTime())
+                                 + " given after the end of the arrivals");
+    if (newArrivalEvent.getTime() < horizon)
+        throw std::runtime_error("arrival at " + std::to_string(newArrivalEvent.getTime())
+                                 + " given after the run was advanced to " + std::to_string(horizon));
+    acceptArrival(newArrivalEvent);
+    pushedArrivals.enqueue(newArrivalEvent);
+}
+
+// Description: Tells the run that no more arrivals will come.
+void Simulation::endArrivals() {
+    arrivalsEnded = true;
+}
+
+// Description: Returns true if the next event is known, in time its time.
+//              A departure before an arrival given is known to come next; without
+//              one, only once the arrivals have ended or if it is before the time
+//              given to runUntil(). Every arrival given and not processed yet has
+//              been counted as read, but not as a customer.
+bool Simulation::peekNextEvent(int &time) {
+    bool arriving;
+    if (!peekEvent(time, arriving))
+        return false;
+    return arriving || arrivalsRead > customerCount || arrivalsEnded || time < horizon;
+}
+
+// Description: Processes the next event, if it is known.
+bool Simulation::step() {
+    int time;
+    if (!peekNextEvent(time))
+        return false;
+    processNextEvent();
+    return true;
+}
+
+// Description: Processes every event before time.
+void Simulation::runUntil(int time) {
+    BSIM_PHASE(RUN);
+    if (time > horizon)
+        horizon = time;
+    int nextTime;
+    while (peekNextEvent(nextTime) && nextTime < time)
+        processNextEvent();
+}
+
+// Description: Ends the arrivals, processes every event left and flushes the log.
+void Simulation::finish() {
+    BSIM_PHASE(RUN);
+    endArrivals();
+    int time;
+    while (peekNextEvent(time))
+        processNextEvent();
+    if (intervals != nullptr)
+        intervals->finish();
+    traceLog->flush();
+}
+
+// Description: Returns the time of the last event processed.
+int Simulation::getCurrentTime() const {
+    return currentTime;
+}
+
+// Description: Returns the number of customers that arrived.
+long long Simulation::getCustomerCount() const {
+    return customerCount;
+}
+
+// Description: Returns the sum of the time customers spent waiting in line.
+long long Simulation::getTotalWait() const {
+    return statistics.getWait().getTotal();
+}
+
+// Description: Returns the statistics of the run.
+const SimulationStatistics & Simulation::getStatistics() const {
+    return statistics;
+}
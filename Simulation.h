@@ -0,0 +1,242 @@
+/*
+ * Simulation.h
+ *
+ * Description: Event driven simulation of a bank branch with one or more tellers.
+ *              Customers either wait in one line shared by all tellers, or each
+ *              teller has its own line and arriving customers join the line of
+ *              the teller with the fewest customers (join-shortest-queue).
+ *
+ *              The engine itself is EventSimulation, instantiated for each kind
+ *              of event queue; create() picks one at run time. For a single teller
+ *              create() picks LindleySimulation instead, which gives the same
+ *              results without an event queue.
+ *
+ *              A simulation is run either over a whole input at once (run()), or
+ *              driven by its caller (begin()): arrivals are fed one by one with
+ *              addArrival() and the events processed with step(), runUntil() and
+ *              finish(), with the statistics available at any point. Given each
+ *              arrival before the run is advanced to its time, as run() reads them,
+ *              both give the same results, bit for bit, so a program can embed the
+ *              engine (libbanksim.a) rather than run bsim and read its output.
+ *
+ *              A run can take checkpoints as it goes (setCheckpointer()) and a new
+ *              simulation with the same tellers and line discipline can resume it
+ *              from one (resume()); it then ends with the statistics the run would
+ *              have had without stopping (see Checkpoint.h).
+ *
+ * Class Invariant: A customer only waits in a line while their teller is busy.
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <climits>
+#include <string>
+#include "Event.h"
+#include "Queue.h"
+#include "ArrivalReader.h"
+#include "TellerPool.h"
+#include "TraceLog.h"
+#include "MonotonicArena.h"
+#include "Statistics.h"
+#include "IntervalMetrics.h"
+#include "Checkpoint.h"
+
+class Simulation {
+
+    public:
+        enum LineDiscipline { SHARED_LINE, SHORTEST_LINE };   // One line for all tellers, one line per teller
+        enum Scheduler { BINARY_HEAP, QUATERNARY_HEAP, CALENDAR_QUEUE,   // What keeps the event queue
+                         STRUCTURE_OF_ARRAYS };                          // (and the lines: SoA keeps both)
+
+        // A bank line's length swings up and down with the load: it only gives memory
+        // back once it is down to 1/8 of its array, so it does not reallocate each time.
+        typedef Queue<Event, LazyShrink> BankLine;
+
+    protected:
+        LineDiscipline discipline;
+        unsigned int numberOfLines;                // One shared line, or one per teller
+        TellerPool tellers;                            // Customers being served or waiting at each teller
+        TraceLog *traceLog = nullptr;              // Log of the run in progress
+        IntervalMetrics *intervals = nullptr;      // Per-interval metrics, if wanted
+        Checkpointer *checkpoints = nullptr;       // Takes checkpoints of the run, if wanted
+
+        int currentTime = 0;
+        long long customerCount = 0;        // Number of customers
+        long long arrivalsRead = 0;         // Arrivals taken from the input so far
+        int lastArrivalTime = INT_MIN;      // Time of the last arrival read, to check the input is sorted
+        unsigned int numberOfThreads = 1;   // Threads run() may use, where the engine can
+        SimulationStatistics statistics;    // Wait times, line lengths and busy tellers
+        BankLine pushedArrivals;            // Arrivals given by addArrival() and not processed yet
+        bool arrivalsEnded = false;         // endArrivals() was called: no more arrivals will come
+        int horizon = INT_MIN;              // No arrival will come before this time (see runUntil())
+
+        // Description: Constructor
+        Simulation(unsigned int numberOfTellers, LineDiscipline aDiscipline);
+
+        // Description: Returns the index of the line the customers of teller wait in.
+        unsigned int lineIndexOf(unsigned int teller) const;
+
+        // Description: Reads the next arrival of arrivals into newArrivalEvent, false at the end of them.
+        // Exceptions: Throws runtime_error if it arrives before the arrival read before it,
+        //             and whatever arrivals throws when it cannot be read.
+        bool readArrival(ArrivalReader &arrivals, Event &newArrivalEvent);
+
+        // Description: Checks that newArrivalEvent does not arrive before the arrival
+        //              before it, and counts it.
+        // Exceptions: Throws runtime_error if it does.
+        void acceptArrival(const Event &newArrivalEvent);
+
+        // Description: Takes a checkpoint if one is due. Returns true if the run is to stop.
+        // Precondition: An arrival has just been processed and the next one is not read yet.
+        bool checkpointIfDue();
+
+        // Description: Writes the events and lines of the engine to aCheckpoint, and reads
+        //              them back; saveEngine() leaves them as they were.
+        virtual void saveEngine(CheckpointWriter &aCheckpoint) = 0;
+        virtual void restoreEngine(CheckpointReader &aCheckpoint) = 0;
+
+        // Description: Returns in time the time of the first event among the arrivals
+        //              given (pushedArrivals, which the engine may take) and the departures
+        //              scheduled, and in arriving whether it is an arrival; false if there
+        //              is none.
+        virtual bool peekEvent(int &time, bool &arriving) = 0;
+
+        // Description: Processes that event, as run() would.
+        // Precondition: peekEvent() returned true.
+        virtual void processNextEvent() = 0;
+
+        // Description: Returns true if the next event of a run begun with begin() is known,
+        //              in time its time: false if there is none, or if an arrival still to
+        //              be given may come before it.
+        bool peekNextEvent(int &time);
+
+    public:
+        // Description: Creates a simulation whose event queue is kept by scheduler,
+        //              or the analytic LindleySimulation if there is a single teller.
+        //              The caller deletes it.
+        //              With an arena (binary heap scheduler only), the event queue and the
+        //              lines take their memory from it and never shrink; reset the arena
+        //              only after deleting the simulation.
+        static Simulation *create(unsigned int numberOfTellers = 1, LineDiscipline aDiscipline = SHARED_LINE,
+                                  Scheduler scheduler = BINARY_HEAP, MonotonicArena *arena = nullptr);
+
+        // Description: Same as create(), but always the event driven engine, even for a
+        //              single teller: the reference the fast paths are checked against.
+        static Simulation *createEventDriven(unsigned int numberOfTellers = 1, LineDiscipline aDiscipline = SHARED_LINE,
+                                             Scheduler scheduler = BINARY_HEAP, MonotonicArena *arena = nullptr);
+
+        // Description: Destructor
+        virtual ~Simulation();
+
+        Simulation(const Simulation &) = delete;
+        Simulation & operator=(const Simulation &) = delete;
+
+        // Description: Makes run() also report its metrics interval by interval to someIntervals.
+        void setIntervalMetrics(IntervalMetrics *someIntervals);
+
+        // Description: Lets run() use up to aNumberOfThreads threads where the engine can:
+        //              LindleySimulation scans a run without event log or interval metrics
+        //              in parallel; the event driven engine always runs on one thread.
+        void setThreadCount(unsigned int aNumberOfThreads);
+
+        // Description: Makes run() take a checkpoint with someCheckpoints whenever one is due.
+        void setCheckpointer(Checkpointer *someCheckpoints);
+
+        // Description: Writes the state of the run in progress to aCheckpoint.
+        // Precondition: run() is between an arrival and the next (see checkpointIfDue()).
+        // Time Efficiency: O(customers in the bank)
+        void save(CheckpointWriter &aCheckpoint);
+
+        // Description: Writes the state the rest of the run depends on (clock, statistics,
+        //              teller loads, events and lines), but not the number of customers,
+        //              to aCheckpoint. Two runs that write the same bytes here go on the
+        //              same way given the same arrivals.
+        // Precondition: As for save(); every arrival given has been processed.
+        // Time Efficiency: O(customers in the bank)
+        void saveState(CheckpointWriter &aCheckpoint);
+
+        // Description: Restores the state written by saveState() of a run that had
+        //              processed customers arrivals, for a run driven by the caller.
+        // Precondition: Neither run() nor begin() has been called.
+        // Exceptions: Throws runtime_error if aCheckpoint is truncated, corrupt or for
+        //             another number of tellers or engine.
+        // Time Efficiency: O(customers in the bank)
+        void restoreState(CheckpointReader &aCheckpoint, long long customers);
+
+        // Description: Returns the statistics so far and starts them over from now, the
+        //              people waiting and busy tellers carrying on: merged in order, the
+        //              parts give the statistics of the whole run.
+        SimulationStatistics splitStatistics();
+
+        // Description: Restores the state of the run checkpointed in fileName and skips
+        //              the arrivals it had read, so that run() goes on from there.
+        // Precondition: run() has not been called; arrivals is the input of the run.
+        // Exceptions: Throws runtime_error if fileName is not a checkpoint of a run with
+        //             the same tellers, line discipline and engine, or arrivals is shorter
+        //             than the part of it the run had read.
+        // Time Efficiency: O(customers in the bank + arrivals skipped)
+        void resume(const std::string &fileName, ArrivalReader &arrivals);
+
+        // Description: Returns true if the run stopped at a checkpoint, before the end of arrivals.
+        bool isStopped() const;
+
+        // Description: Runs the simulation over all arrivals, logging events to aTraceLog.
+        // Precondition: arrivals are sorted by time.
+        // Exceptions: Throws runtime_error if the arrivals are not sorted by time,
+        //             or the interval metrics cannot be written,
+        //             and whatever arrivals throws when it cannot be read.
+        virtual void run(ArrivalReader &arrivals, TraceLog &aTraceLog) = 0;
+
+        // Description: Begins a run driven by the caller rather than by run(), logging
+        //              events to aTraceLog, or nowhere. Arrivals are then fed with
+        //              addArrival() and the events processed with step(), runUntil() and
+        //              finish(); checkpoints are only taken by run().
+        // Precondition: run() has not been called, and begin() not yet.
+        void begin();
+        void begin(TraceLog &aTraceLog);
+
+        // Description: Gives the run the next arrival. It is only processed once it is
+        //              known to come before every other pending event.
+        // Precondition: begin() was called and endArrivals() not yet.
+        // Exceptions: Throws runtime_error if newArrivalEvent arrives before the arrival
+        //             given before it, or before the time given to runUntil().
+        // Time Efficiency: O(1) amortized
+        void addArrival(const Event &newArrivalEvent);
+
+        // Description: Tells the run that no more arrivals will come, so the departures
+        //              after the last arrival can be processed.
+        void endArrivals();
+
+        // Description: Processes the next event, if it is known: returns false if there is
+        //              none, or if an arrival still to be given may come before it.
+        // Precondition: begin() was called.
+        // Time Efficiency: O(log n) in the number of pending events
+        bool step();
+
+        // Description: Processes every event before time; it also tells the run that no
+        //              arrival given from now on comes before time. Departures at the
+        //              same time at different tellers may leave in another order than in
+        //              run() if the next arrival, before time, is not given yet.
+        // Precondition: begin() was called.
+        void runUntil(int time);
+
+        // Description: Ends the arrivals, processes every event left and flushes the log,
+        //              leaving the statistics where run() leaves them.
+        // Precondition: begin() was called.
+        // Exceptions: Throws runtime_error if the interval metrics cannot be written.
+        void finish();
+
+        // Description: Returns the time of the last event processed.
+        int getCurrentTime() const;
+
+        // Description: Returns the number of customers that arrived.
+        long long getCustomerCount() const;
+
+        // Description: Returns the sum of the time customers spent waiting in line.
+        long long getTotalWait() const;
+
+        // Description: Returns the statistics of the run.
+        const SimulationStatistics &getStatistics() const;
+};
+#endif
@@ -0,0 +1,348 @@
+/*
+ * Statistics.cpp
+ *
+ * Description: Streaming statistics of a simulation run, in O(1) memory:
+ *              RunningStatistics, QuantileSketch and SimulationStatistics
+ *              (see Statistics.h).
+ *
+ * Class Invariant: Every value added is counted once.
+ */
+
+#include <cmath>
+#include <stdexcept>
+#include "Statistics.h"
+#include "Checkpoint.h"
+
+using std::endl;
+
+
+// Description: Adds value.
+//              Welford's update keeps the mean and the squared differences from it,
+//              which stay small where a sum of squares would overflow.
+void RunningStatistics::add(long long value) {
+    count++;
+    total += value;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+    if (count == 1 || value > maximum)
+        maximum = value;
+}
+
+// Description: Adds every value other has seen (Chan et al.'s pairwise update).
+void RunningStatistics::merge(const RunningStatistics &other) {
+    if (other.count == 0)
+        return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    double newCount = double(count) + double(other.count);
+    double delta = other.mean - mean;
+    mean += delta * other.count / newCount;
+    m2 += other.m2 + delta * delta * (double(count) * other.count / newCount);
+    count += other.count;
+    total += other.total;
+    if (other.maximum > maximum)
+        maximum = other.maximum;
+}
+
+// Description: Returns the number of values.
+unsigned long long RunningStatistics::getCount() const {
+    return count;
+}
+
+// Description: Returns the sum of the values.
+long long RunningStatistics::getTotal() const {
+    return total;
+}
+
+// Description: Returns the mean of the values, 0 if there are none.
+double RunningStatistics::getMean() const {
+    return mean;
+}
+
+// Description: Returns the (population) variance of the values, 0 if there are none.
+double RunningStatistics::getVariance() const {
+    return count == 0 ? 0 : m2 / count;
+}
+
+// Description: Returns the standard deviation of the values, 0 if there are none.
+double RunningStatistics::getStandardDeviation() const {
+    return std::sqrt(getVariance());
+}
+
+// Description: Returns the largest value, 0 if there are none.
+long long RunningStatistics::getMaximum() const {
+    return maximum;
+}
+
+// Description: Returns true if rhs holds exactly the same statistics, bit for bit.
+bool RunningStatistics::operator==(const RunningStatistics &rhs) const {
+    return count == rhs.count && total == rhs.total && mean == rhs.mean && m2 == rhs.m2
+           && maximum == rhs.maximum;
+}
+
+// Description: Writes the statistics to aCheckpoint.
+void RunningStatistics::save(CheckpointWriter &aCheckpoint) const {
+    aCheckpoint.putInt64(count);
+    aCheckpoint.putInt64(total);
+    aCheckpoint.putDouble(mean);
+    aCheckpoint.putDouble(m2);
+    aCheckpoint.putInt64(maximum);
+}
+
+// Description: Reads the statistics back from aCheckpoint.
+void RunningStatistics::restore(CheckpointReader &aCheckpoint) {
+    count = aCheckpoint.getInt64();
+    total = aCheckpoint.getInt64();
+    mean = aCheckpoint.getDouble();
+    m2 = aCheckpoint.getDouble();
+    maximum = aCheckpoint.getInt64();
+}
+
+
+// Description: Returns the bucket of value.
+//              Above EXACT_VALUES, the bucket is given by the position of the highest
+//              bit set (the octave) and the EXACT_BITS - 1 bits below it.
+unsigned int QuantileSketch::bucketOf(uint32_t value) {
+    if (value < EXACT_VALUES)
+        return value;
+    unsigned int octave = 31 - __builtin_clz(value);          // >= EXACT_BITS
+    unsigned int shift = octave - (EXACT_BITS - 1);
+    return EXACT_VALUES + (octave - EXACT_BITS) * BUCKETS_PER_OCTAVE + ((value >> shift) - BUCKETS_PER_OCTAVE);
+}
+
+// Description: Returns the value reported for the values in bucket (their midpoint).
+uint32_t QuantileSketch::valueOf(unsigned int bucket) {
+    if (bucket < EXACT_VALUES)
+        return bucket;
+    unsigned int shift = (bucket - EXACT_VALUES) / BUCKETS_PER_OCTAVE + 1;
+    uint32_t lowest = ((bucket - EXACT_VALUES) % BUCKETS_PER_OCTAVE + BUCKETS_PER_OCTAVE) << shift;
+    return lowest + ((1u << shift) - 1) / 2;
+}
+
+// Description: Adds value. Negative values count as 0.
+void QuantileSketch::add(long long value) {
+    if (value < 0)
+        value = 0;
+    if (value > (long long)UINT32_MAX)
+        value = UINT32_MAX;
+    counts[bucketOf((uint32_t)value)]++;
+    count++;
+}
+
+// Description: Adds every value other has seen.
+void QuantileSketch::merge(const QuantileSketch &other) {
+    for (unsigned int i = 0; i < NUMBER_OF_BUCKETS; i++)
+        counts[i] += other.counts[i];
+    count += other.count;
+}
+
+// Description: Returns the number of values.
+unsigned long long QuantileSketch::getCount() const {
+    return count;
+}
+
+// Description: Returns the q-quantile (0 <= q <= 1) of the values, 0 if there are none.
+//              That is the value of rank ceil(q * count), counting from 1.
+long long QuantileSketch::quantile(double q) const {
+    if (count == 0)
+        return 0;
+    unsigned long long rank = (unsigned long long)std::ceil(q * count);
+    if (rank < 1)
+        rank = 1;
+    if (rank > count)
+        rank = count;
+
+    unsigned long long seen = 0;
+    for (unsigned int i = 0; i < NUMBER_OF_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank)
+            return valueOf(i);
+    }
+    return valueOf(NUMBER_OF_BUCKETS - 1);
+}
+
+// Description: Returns true if rhs counted the same values.
+bool QuantileSketch::operator==(const QuantileSketch &rhs) const {
+    if (count != rhs.count)
+        return false;
+    for (unsigned int i = 0; i < NUMBER_OF_BUCKETS; i++)
+        if (counts[i] != rhs.counts[i])
+            return false;
+    return true;
+}
+
+// Description: Writes the sketch to aCheckpoint: the number of buckets in use,
+//              then the index and count of each of them.
+void QuantileSketch::save(CheckpointWriter &aCheckpoint) const {
+    uint32_t inUse = 0;
+    for (unsigned int i = 0; i < NUMBER_OF_BUCKETS; i++)
+        inUse += (counts[i] != 0);
+    aCheckpoint.putUInt32(inUse);
+    for (unsigned int i = 0; i < NUMBER_OF_BUCKETS; i++)
+        if (counts[i] != 0) {
+            aCheckpoint.putUInt32(i);
+            aCheckpoint.putInt64(counts[i]);
+        }
+}
+
+// Description: Reads the sketch back from aCheckpoint.
+void QuantileSketch::restore(CheckpointReader &aCheckpoint) {
+    *this = QuantileSketch();
+    uint32_t inUse = aCheckpoint.getUInt32();
+    for (uint32_t i = 0; i < inUse; i++) {
+        uint32_t bucket = aCheckpoint.getUInt32();
+        if (bucket >= NUMBER_OF_BUCKETS)
+            throw std::runtime_error("checkpoint " + aCheckpoint.getFileName() + " is corrupt");
+        counts[bucket] = aCheckpoint.getInt64();
+        count += counts[bucket];
+    }
+}
+
+
+// Description: Constructor
+SimulationStatistics::SimulationStatistics(unsigned int aNumberOfTellers) : numberOfTellers(aNumberOfTellers) { }
+
+// Description: Moves the clock to time, counting the people waiting and the busy
+//              tellers since the last call towards the time averages.
+void SimulationStatistics::advanceTo(long long time) {
+    if (started) {
+        long long interval = time - lastTime;
+        waitingArea += double(waiting) * interval;
+        busyArea += double(busy) * interval;
+        elapsed += interval;
+    }
+    started = true;
+    lastTime = time;
+}
+
+// Description: Records the wait of a customer whose service starts now.
+void SimulationStatistics::recordWait(long long waitTime) {
+    wait.add(waitTime);
+    waitQuantiles.add(waitTime);
+}
+
+// Description: Records a customer joining a line.
+void SimulationStatistics::joinLine() {
+    waiting++;
+    if (waiting > maximumWaiting)
+        maximumWaiting = waiting;
+}
+
+// Description: Records a customer leaving a line.
+void SimulationStatistics::leaveLine() {
+    waiting--;
+}
+
+// Description: Records a teller starting to serve customers.
+void SimulationStatistics::tellerBusy() {
+    busy++;
+}
+
+// Description: Records a teller stopping to serve customers.
+void SimulationStatistics::tellerIdle() {
+    busy--;
+}
+
+// Description: Adds the statistics of other, for instance another part of the same run.
+//              The time averages of the two are weighted by the time they cover.
+void SimulationStatistics::merge(const SimulationStatistics &other) {
+    wait.merge(other.wait);
+    waitQuantiles.merge(other.waitQuantiles);
+    elapsed += other.elapsed;
+    waitingArea += other.waitingArea;
+    busyArea += other.busyArea;
+    if (other.maximumWaiting > maximumWaiting)
+        maximumWaiting = other.maximumWaiting;
+}
+
+// Description: Returns the statistics so far and starts over from the time of the
+//              last advanceTo(), with the people waiting and the busy tellers as they are.
+//              The longest line of the new part starts at the line as it is.
+SimulationStatistics SimulationStatistics::split() {
+    SimulationStatistics part = *this;
+    wait = RunningStatistics();
+    waitQuantiles = QuantileSketch();
+    elapsed = 0;
+    maximumWaiting = waiting;
+    waitingArea = 0;
+    busyArea = 0;
+    return part;
+}
+
+// Description: Returns the statistics of the wait times.
+const RunningStatistics & SimulationStatistics::getWait() const {
+    return wait;
+}
+
+// Description: Returns the sketch of the wait times.
+const QuantileSketch & SimulationStatistics::getWaitQuantiles() const {
+    return waitQuantiles;
+}
+
+// Description: Returns the time average of the number of people waiting in line.
+double SimulationStatistics::getAverageLineLength() const {
+    return elapsed == 0 ? 0 : waitingArea / elapsed;
+}
+
+// Description: Returns the most people that were waiting in line at once.
+unsigned long long SimulationStatistics::getMaximumLineLength() const {
+    return maximumWaiting;
+}
+
+// Description: Returns the fraction of the time the tellers were busy.
+double SimulationStatistics::getUtilization() const {
+    return elapsed == 0 ? 0 : busyArea / (double(elapsed) * numberOfTellers);
+}
+
+// Description: Prints the statistics, one per line, in the style of the final statistics.
+void SimulationStatistics::print(std::ostream &output) const {
+    output << "    Standard deviation of the wait: " << wait.getStandardDeviation() << endl;
+    output << "    Longest wait: " << wait.getMaximum() << endl;
+    output << "    Wait percentiles (p50 / p90 / p99): " << waitQuantiles.quantile(0.5) << " / "
+           << waitQuantiles.quantile(0.9) << " / " << waitQuantiles.quantile(0.99) << endl;
+    output << "    Average number of people waiting in line: " << getAverageLineLength()
+           << " (at most " << maximumWaiting << " at once)" << endl;
+    output << "    Teller utilization: " << 100 * getUtilization() << "%" << endl;
+}
+
+// Description: Returns true if rhs holds exactly the same statistics, bit for bit.
+bool SimulationStatistics::operator==(const SimulationStatistics &rhs) const {
+    return numberOfTellers == rhs.numberOfTellers && wait == rhs.wait && waitQuantiles == rhs.waitQuantiles
+           && elapsed == rhs.elapsed && waiting == rhs.waiting && maximumWaiting == rhs.maximumWaiting
+           && busy == rhs.busy && waitingArea == rhs.waitingArea && busyArea == rhs.busyArea;
+}
+
+// Description: Writes the statistics, clock included, to aCheckpoint.
+void SimulationStatistics::save(CheckpointWriter &aCheckpoint) const {
+    aCheckpoint.putUInt32(numberOfTellers);
+    wait.save(aCheckpoint);
+    waitQuantiles.save(aCheckpoint);
+    aCheckpoint.putUInt8(started);
+    aCheckpoint.putInt64(lastTime);
+    aCheckpoint.putInt64(elapsed);
+    aCheckpoint.putInt64(waiting);
+    aCheckpoint.putInt64(maximumWaiting);
+    aCheckpoint.putUInt32(busy);
+    aCheckpoint.putDouble(waitingArea);
+    aCheckpoint.putDouble(busyArea);
+}
+
+// Description: Reads the statistics, clock included, back from aCheckpoint.
+void SimulationStatistics::restore(CheckpointReader &aCheckpoint) {
+    if (aCheckpoint.getUInt32() != numberOfTellers)
+        throw std::runtime_error("checkpoint " + aCheckpoint.getFileName() + " is for another number of tellers");
+    wait.restore(aCheckpoint);
+    waitQuantiles.restore(aCheckpoint);
+    started = aCheckpoint.getUInt8();
+    lastTime = aCheckpoint.getInt64();
+    elapsed = aCheckpoint.getInt64();
+    waiting = aCheckpoint.getInt64();
+    maximumWaiting = aCheckpoint.getInt64();
+    busy = aCheckpoint.getUInt32();
+    waitingArea = aCheckpoint.getDouble();
+    busyArea = aCheckpoint.getDouble();
+}
@@ -0,0 +1,206 @@
+/*
+ * Statistics.h
+ *
+ * Description: Streaming statistics of a simulation run, in O(1) memory:
+ *              RunningStatistics  count, exact total, mean, variance and maximum
+ *                                 (Welford's update, so no sum of squares overflows),
+ *              QuantileSketch     approximate quantiles from a fixed log-linear
+ *                                 histogram (exact below 128, within 1/128 above),
+ *              SimulationStatistics  the wait time of the customers with both of the
+ *                                 above, and the time averages of the number of people
+ *                                 waiting in line and of the busy tellers.
+ *              Each of them can merge the statistics of another run (or of another
+ *              part of the same run), giving the same result as if it had seen all
+ *              the values itself, so parallel or sharded runs combine their results
+ *              without going over the data again.
+ *
+ * Class Invariant: Every value added is counted once.
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <cstdint>
+#include <ostream>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+class RunningStatistics {
+
+    private:
+        unsigned long long count = 0;
+        long long total = 0;          // Exact sum of the values
+        double mean = 0;              // Running mean
+        double m2 = 0;                // Sum of the squared differences from the mean
+        long long maximum = 0;
+
+    public:
+        // Description: Adds value.
+        // Time Efficiency: O(1)
+        void add(long long value);
+
+        // Description: Adds every value other has seen (Chan et al.'s pairwise update).
+        // Time Efficiency: O(1)
+        void merge(const RunningStatistics &other);
+
+        // Description: Returns the number of values.
+        unsigned long long getCount() const;
+
+        // Description: Returns the sum of the values.
+        long long getTotal() const;
+
+        // Description: Returns the mean of the values, 0 if there are none.
+        double getMean() const;
+
+        // Description: Returns the (population) variance of the values, 0 if there are none.
+        double getVariance() const;
+
+        // Description: Returns the standard deviation of the values, 0 if there are none.
+        double getStandardDeviation() const;
+
+        // Description: Returns the largest value, 0 if there are none.
+        long long getMaximum() const;
+
+        // Description: Returns true if rhs holds exactly the same statistics, bit for bit
+        //              (e.g. it saw the same values in the same order).
+        bool operator==(const RunningStatistics &rhs) const;
+
+        // Description: Writes the statistics to aCheckpoint, and reads them back.
+        // Exceptions: restore() throws runtime_error if the checkpoint is truncated.
+        void save(CheckpointWriter &aCheckpoint) const;
+        void restore(CheckpointReader &aCheckpoint);
+};
+
+
+class QuantileSketch {
+
+    private:
+        // Values below 2^EXACT_BITS have a bucket each; above, every power of 2
+        // is split into 2^(EXACT_BITS - 1) buckets of equal width.
+        static unsigned int const EXACT_BITS = 7;
+        static unsigned int const EXACT_VALUES = 1u << EXACT_BITS;             // 128
+        static unsigned int const BUCKETS_PER_OCTAVE = EXACT_VALUES / 2;       // 64
+        static unsigned int const NUMBER_OF_BUCKETS = EXACT_VALUES + (32 - EXACT_BITS) * BUCKETS_PER_OCTAVE;
+
+        unsigned long long counts[NUMBER_OF_BUCKETS] = {};
+        unsigned long long count = 0;
+
+        // Description: Returns the bucket of value.
+        static unsigned int bucketOf(uint32_t value);
+
+        // Description: Returns the value reported for the values in bucket (their midpoint).
+        static uint32_t valueOf(unsigned int bucket);
+
+    public:
+        // Description: Adds value. Negative values count as 0.
+        // Time Efficiency: O(1)
+        void add(long long value);
+
+        // Description: Adds every value other has seen.
+        // Time Efficiency: O(number of buckets)
+        void merge(const QuantileSketch &other);
+
+        // Description: Returns the number of values.
+        unsigned long long getCount() const;
+
+        // Description: Returns the q-quantile (0 <= q <= 1) of the values, 0 if there are none.
+        //              Exact below 128, otherwise within 1/128 of a value of that rank.
+        // Time Efficiency: O(number of buckets)
+        long long quantile(double q) const;
+
+        // Description: Returns true if rhs counted the same values.
+        // Time Efficiency: O(number of buckets)
+        bool operator==(const QuantileSketch &rhs) const;
+
+        // Description: Writes the sketch to aCheckpoint (only the buckets in use), and
+        //              reads it back.
+        // Exceptions: restore() throws runtime_error if the checkpoint is truncated or corrupt.
+        // Time Efficiency: O(number of buckets)
+        void save(CheckpointWriter &aCheckpoint) const;
+        void restore(CheckpointReader &aCheckpoint);
+};
+
+
+class SimulationStatistics {
+
+    private:
+        unsigned int numberOfTellers;
+        RunningStatistics wait;              // Wait time of every customer served
+        QuantileSketch waitQuantiles;
+
+        bool started = false;                // Whether the clock has been set by advanceTo()
+        long long lastTime = 0;              // Time of the last advanceTo()
+        long long elapsed = 0;               // Time covered by the time averages
+        unsigned long long waiting = 0;      // People waiting in line now
+        unsigned long long maximumWaiting = 0;
+        unsigned int busy = 0;               // Tellers serving a customer now
+        double waitingArea = 0;              // Integral of waiting over time
+        double busyArea = 0;                 // Integral of busy over time
+
+    public:
+        // Description: Constructor
+        SimulationStatistics(unsigned int aNumberOfTellers);
+
+        // Description: Moves the clock to time, counting the people waiting and the busy
+        //              tellers since the last call towards the time averages.
+        //              The first call only sets the clock.
+        // Precondition: time is not before the time of the last call.
+        // Time Efficiency: O(1)
+        void advanceTo(long long time);
+
+        // Description: Records the wait of a customer whose service starts now.
+        // Time Efficiency: O(1)
+        void recordWait(long long waitTime);
+
+        // Description: Records a customer joining, or leaving, a line.
+        void joinLine();
+        void leaveLine();
+
+        // Description: Records a teller starting, or stopping, to serve customers.
+        void tellerBusy();
+        void tellerIdle();
+
+        // Description: Adds the statistics of other, for instance another part of the same run.
+        // Precondition: other has the same number of tellers.
+        // Time Efficiency: O(number of buckets of the sketch)
+        void merge(const SimulationStatistics &other);
+
+        // Description: Returns the statistics so far and starts over from the time of the
+        //              last advanceTo(), with the people waiting and the busy tellers as
+        //              they are: merging the parts in order gives the whole.
+        // Time Efficiency: O(number of buckets of the sketch)
+        SimulationStatistics split();
+
+        // Description: Returns the statistics of the wait times.
+        const RunningStatistics &getWait() const;
+
+        // Description: Returns the sketch of the wait times.
+        const QuantileSketch &getWaitQuantiles() const;
+
+        // Description: Returns the time average of the number of people waiting in line.
+        double getAverageLineLength() const;
+
+        // Description: Returns the most people that were waiting in line at once.
+        unsigned long long getMaximumLineLength() const;
+
+        // Description: Returns the fraction of the time the tellers were busy.
+        double getUtilization() const;
+
+        // Description: Prints the statistics, one per line, in the style of the final statistics.
+        void print(std::ostream &output) const;
+
+        // Description: Returns true if rhs holds exactly the same statistics, bit for bit,
+        //              as two engines that process the same events in the same order do.
+        // Time Efficiency: O(number of buckets of the sketch)
+        bool operator==(const SimulationStatistics &rhs) const;
+
+        // Description: Writes the statistics, clock included, to aCheckpoint, and reads
+        //              them back, so the run goes on as if it had not stopped.
+        // Exceptions: restore() throws runtime_error if the checkpoint is truncated,
+        //             corrupt or for another number of tellers.
+        // Time Efficiency: O(number of buckets of the sketch)
+        void save(CheckpointWriter &aCheckpoint) const;
+        void restore(CheckpointReader &aCheckpoint);
+};
+#endif
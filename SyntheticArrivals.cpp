@@ -0,0 +1,127 @@
+/*
+ * SyntheticArrivals.cpp
+ *
+ * Description: Generates synthetic arrival streams, in time order, for benchmarks
+ *              and experiments (see SyntheticArrivals.h).
+ *
+ * Class Invariant: Arrivals are handed out in time order, at most count of them.
+ */
+
+#include <climits>
+#include <cmath>
+#include "SyntheticArrivals.h"
+
+using std::string;
+
+
+// Description: Returns the name of pattern ("poisson", "bursty", "diurnal").
+const char *SyntheticArrivalReader::nameOf(Pattern pattern) {
+    switch (pattern) {
+        case BURSTY:
+            return "bursty";
+        case DIURNAL:
+            return "diurnal";
+        default:
+            return "poisson";
+    }
+}
+
+// Description: Returns the name of service ("exponential", "pareto").
+const char *SyntheticArrivalReader::nameOf(Service service) {
+    return service == PARETO ? "pareto" : "exponential";
+}
+
+// Description: Sets pattern to the one named name.
+bool SyntheticArrivalReader::parse(const string &name, Pattern &pattern) {
+    for (Pattern candidate : { POISSON, BURSTY, DIURNAL })
+        if (name == nameOf(candidate)) {
+            pattern = candidate;
+            return true;
+        }
+    return false;
+}
+
+// Description: Sets service to the one named name.
+bool SyntheticArrivalReader::parse(const string &name, Service &service) {
+    for (Service candidate : { EXPONENTIAL, PARETO })
+        if (name == nameOf(candidate)) {
+            service = candidate;
+            return true;
+        }
+    return false;
+}
+
+// Description: Constructor
+SyntheticArrivalReader::SyntheticArrivalReader(const Workload &aWorkload)
+    : workload(aWorkload), generator(aWorkload.seed), uniform(0.0, 1.0) { }
+
+// Description: Returns an exponential variate of mean mean.
+double SyntheticArrivalReader::exponential(double mean) {
+    return -mean * std::log(1.0 - uniform(generator));
+}
+
+// Description: Returns the gap to the next arrival.
+double SyntheticArrivalReader::nextGap() {
+    double rate = 1.0 / workload.meanGap;
+
+    if (workload.pattern == BURSTY) {
+        // Bursts take 1/5 of the time, so that 4 * 1/5 + 1/4 * 4/5 = 1 (the mean rate).
+        // Arrivals and switches of state are competing exponential clocks.
+        double burstDuration = BURST_LENGTH / (BURST_FACTOR * rate);
+        double gap = 0;
+        while (true) {
+            double arrivalRate = inBurst ? BURST_FACTOR * rate : rate / BURST_FACTOR;
+            double switchRate = inBurst ? 1.0 / burstDuration : 1.0 / (4 * burstDuration);
+            gap += exponential(1.0 / (arrivalRate + switchRate));
+            if (uniform(generator) * (arrivalRate + switchRate) < arrivalRate)
+                return gap;
+            inBurst = !inBurst;
+        }
+    }
+
+    if (workload.pattern == DIURNAL) {
+        // Thinning: candidates at the peak rate, kept with probability rate(t) / peak rate
+        double peakRate = rate * (1 + DIURNAL_SWING);
+        double gap = 0;
+        while (true) {
+            gap += exponential(1.0 / peakRate);
+            double phase = 2 * M_PI * (time + gap) / workload.day;
+            if (uniform(generator) * (1 + DIURNAL_SWING) < 1 + DIURNAL_SWING * std::sin(phase))
+                return gap;
+        }
+    }
+
+    return exponential(workload.meanGap);
+}
+
+// Description: Returns the next transaction length, at least 1.
+int SyntheticArrivalReader::nextLength() {
+    double length;
+    if (workload.service == PARETO) {
+        // Scale chosen so that the mean is meanLength
+        double scale = workload.meanLength * (PARETO_SHAPE - 1) / PARETO_SHAPE;
+        length = scale / std::pow(1.0 - uniform(generator), 1.0 / PARETO_SHAPE);
+    }
+    else
+        length = exponential(workload.meanLength);
+
+    if (length < 1)
+        return 1;
+    if (length > INT_MAX / 2)
+        return INT_MAX / 2;
+    return (int)std::lround(length);
+}
+
+// Description: Generates the next arrival into newEvent.
+bool SyntheticArrivalReader::next(Event &newEvent) {
+    if (generated == workload.count)
+        return false;
+    double nextTime = time + nextGap();
+    if (nextTime > INT_MAX)
+        return false;
+
+    time = nextTime;
+    generated++;
+    newEvent = Event(Event::ARRIVAL, (int)time, nextLength());
+    return true;
+}
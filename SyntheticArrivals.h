@@ -0,0 +1,91 @@
+/*
+ * SyntheticArrivals.h
+ *
+ * Description: Generates synthetic arrival streams, in time order, for benchmarks
+ *              and experiments, as an ArrivalReader like any other input.
+ *              Arrival patterns:
+ *                  POISSON  exponential gaps with a constant rate,
+ *                  BURSTY   a two-state Markov modulated Poisson process: bursts at
+ *                           4 times the mean rate alternate with lulls at 1/4 of it,
+ *                           weighted so that the long run rate is the mean rate,
+ *                  DIURNAL  a Poisson process whose rate follows a sine wave over a
+ *                           day (by thinning), from 0.2 to 1.8 times the mean rate.
+ *              Transaction lengths:
+ *                  EXPONENTIAL  light tailed,
+ *                  PARETO       heavy tailed (shape 1.5: finite mean, infinite variance).
+ *              The same Workload (seed included) always gives the same arrivals.
+ *
+ * Class Invariant: Arrivals are handed out in time order, at most count of them.
+ */
+
+#ifndef SYNTHETIC_ARRIVALS_H
+#define SYNTHETIC_ARRIVALS_H
+
+#include <random>
+#include <string>
+#include "Event.h"
+#include "ArrivalReader.h"
+
+class SyntheticArrivalReader : public ArrivalReader {
+
+    public:
+        enum Pattern { POISSON, BURSTY, DIURNAL };
+        enum Service { EXPONENTIAL, PARETO };
+
+        // What to generate
+        struct Workload {
+            Pattern pattern = POISSON;
+            Service service = EXPONENTIAL;
+            unsigned long long count = 1000000;   // Number of arrivals
+            double meanGap = 10;                  // Mean time between arrivals
+            double meanLength = 8;                // Mean transaction length
+            double day = 86400;                   // DIURNAL: period of the rate
+            unsigned long long seed = 1;
+        };
+
+        // Description: Returns the name of pattern ("poisson", "bursty", "diurnal").
+        static const char *nameOf(Pattern pattern);
+
+        // Description: Returns the name of service ("exponential", "pareto").
+        static const char *nameOf(Service service);
+
+        // Description: Sets pattern to the one named name.
+        //              Returns false if there is no such pattern.
+        static bool parse(const std::string &name, Pattern &pattern);
+
+        // Description: Sets service to the one named name.
+        //              Returns false if there is no such kind of service.
+        static bool parse(const std::string &name, Service &service);
+
+    private:
+        static double constexpr BURST_FACTOR = 4;        // BURSTY: rate in a burst / mean rate
+        static double constexpr BURST_LENGTH = 50;       // BURSTY: mean arrivals per burst
+        static double constexpr DIURNAL_SWING = 0.8;     // DIURNAL: amplitude / mean rate
+        static double constexpr PARETO_SHAPE = 1.5;
+
+        Workload workload;
+        std::mt19937_64 generator;
+        std::uniform_real_distribution<double> uniform;   // [0, 1)
+        unsigned long long generated = 0;
+        double time = 0;                  // Time of the last arrival
+        bool inBurst = false;             // BURSTY: state of the modulating chain
+
+        // Description: Returns an exponential variate of mean mean.
+        double exponential(double mean);
+
+        // Description: Returns the gap to the next arrival.
+        double nextGap();
+
+        // Description: Returns the next transaction length.
+        int nextLength();
+
+    public:
+        // Description: Constructor
+        SyntheticArrivalReader(const Workload &aWorkload);
+
+        // Description: Generates the next arrival into newEvent.
+        //              Returns false once count arrivals were generated, or once the
+        //              time of the next one would not fit in an int.
+        bool next(Event &newEvent);
+};
+#endif
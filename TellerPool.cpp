@@ -0,0 +1,106 @@
+/*
+ * TellerPool.cpp
+ *
+ * Description: Keeps track of how many customers each teller has, being served
+ *              or waiting in the teller's line, and finds the least loaded teller.
+ *              Tellers are kept in an indexed min heap ordered by (load, teller id),
+ *              so the least loaded teller is found in O(1) and updating a load
+ *              costs O(log2 n).
+ *
+ * Class Invariant: heap[0] is the teller with the smallest load, the lowest id
+ *                  among equally loaded tellers.
+ *                  position[heap[i]] == i for every teller.
+ */
+
+#include "TellerPool.h"
+
+// Description: Constructor, all tellers start without customers.
+TellerPool::TellerPool(unsigned int aNumberOfTellers) : numberOfTellers(aNumberOfTellers) {
+    load = new unsigned int[numberOfTellers];
+    heap = new unsigned int[numberOfTellers];
+    position = new unsigned int[numberOfTellers];
+
+    // Tellers in id order with equal loads already form a heap
+    for (unsigned int teller = 0; teller < numberOfTellers; teller++) {
+        load[teller] = 0;
+        heap[teller] = teller;
+        position[teller] = teller;
+    }
+}
+
+// Description: Destructor
+TellerPool::~TellerPool() {
+    delete[] load;
+    delete[] heap;
+    delete[] position;
+}
+
+// Description: Returns the number of tellers.
+unsigned int TellerPool::getNumberOfTellers() const {
+    return numberOfTellers;
+}
+
+// Description: Returns the number of customers at teller.
+unsigned int TellerPool::getLoad(unsigned int teller) const {
+    return load[teller];
+}
+
+// Description: Returns the teller with the fewest customers (lowest id on ties).
+unsigned int TellerPool::leastLoaded() const {
+    return heap[0];
+}
+
+// Description: Records one more customer at teller.
+void TellerPool::addCustomer(unsigned int teller) {
+    load[teller]++;
+    reHeapDown(position[teller]);
+}
+
+// Description: Records one customer less at teller.
+void TellerPool::removeCustomer(unsigned int teller) {
+    load[teller]--;
+    reHeapUp(position[teller]);
+}
+
+// Description: Returns true if teller comes before otherTeller in the heap.
+bool TellerPool::lessLoaded(unsigned int teller, unsigned int otherTeller) const {
+    if (load[teller] == load[otherTeller])
+        return teller < otherTeller;
+    return load[teller] < load[otherTeller];
+}
+
+// Description: Puts teller at index of the heap.
+void TellerPool::place(unsigned int index, unsigned int teller) {
+    heap[index] = teller;
+    position[teller] = index;
+}
+
+// Description: Moves the teller at index up until its parent is less loaded.
+void TellerPool::reHeapUp(unsigned int index) {
+    unsigned int teller = heap[index];
+    while (index > 0) {
+        unsigned int indexOfParent = (index - 1) / 2;
+        if (!lessLoaded(teller, heap[indexOfParent]))
+            break;
+        place(index, heap[indexOfParent]);
+        index = indexOfParent;
+    }
+    place(index, teller);
+}
+
+// Description: Moves the teller at index down until its children are more loaded.
+void TellerPool::reHeapDown(unsigned int index) {
+    unsigned int teller = heap[index];
+    while (true) {
+        unsigned int indexOfMinChild = 2 * index + 1;
+        if (indexOfMinChild >= numberOfTellers)
+            break;
+        if (indexOfMinChild + 1 < numberOfTellers && lessLoaded(heap[indexOfMinChild + 1], heap[indexOfMinChild]))
+            indexOfMinChild++;
+        if (!lessLoaded(heap[indexOfMinChild], teller))
+            break;
+        place(index, heap[indexOfMinChild]);
+        index = indexOfMinChild;
+    }
+    place(index, teller);
+}
@@ -0,0 +1,62 @@
+/*
+ * TellerPool.h
+ *
+ * Description: Keeps track of how many customers each teller has, being served
+ *              or waiting in the teller's line, and finds the least loaded teller.
+ *              Tellers are kept in an indexed min heap ordered by (load, teller id),
+ *              so the least loaded teller is found in O(1) and updating a load
+ *              costs O(log2 n).
+ *
+ * Class Invariant: heap[0] is the teller with the smallest load, the lowest id
+ *                  among equally loaded tellers.
+ *                  position[heap[i]] == i for every teller.
+ */
+
+#ifndef TELLER_POOL_H
+#define TELLER_POOL_H
+
+class TellerPool {
+
+    private:
+        unsigned int numberOfTellers;
+        unsigned int *load;        // Customers at each teller
+        unsigned int *heap;        // Teller ids, least loaded first
+        unsigned int *position;    // Index of each teller in heap
+
+        bool lessLoaded(unsigned int teller, unsigned int otherTeller) const;
+        void place(unsigned int index, unsigned int teller);
+        void reHeapUp(unsigned int index);
+        void reHeapDown(unsigned int index);
+
+    public:
+        // Description: Constructor, all tellers start without customers.
+        TellerPool(unsigned int aNumberOfTellers);
+
+        // Description: Destructor
+        ~TellerPool();
+
+        TellerPool(const TellerPool &) = delete;
+        TellerPool & operator=(const TellerPool &) = delete;
+
+        // Description: Returns the number of tellers.
+        // Time Efficiency: O(1)
+        unsigned int getNumberOfTellers() const;
+
+        // Description: Returns the number of customers at teller.
+        // Time Efficiency: O(1)
+        unsigned int getLoad(unsigned int teller) const;
+
+        // Description: Returns the teller with the fewest customers (lowest id on ties).
+        // Time Efficiency: O(1)
+        unsigned int leastLoaded() const;
+
+        // Description: Records one more customer at teller.
+        // Time Efficiency: O(log2 n)
+        void addCustomer(unsigned int teller);
+
+        // Description: Records one customer less at teller.
+        // Precondition: getLoad(teller) > 0
+        // Time Efficiency: O(log2 n)
+        void removeCustomer(unsigned int teller);
+};
+#endif
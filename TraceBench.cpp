@@ -0,0 +1,100 @@
+/*
+ * TraceBench.cpp
+ *
+ * Description: Benchmarks arrival ingestion: compares reading a text trace with
+ *              stringstreams, reading it with the block parser, and reading the
+ *              same arrivals from a memory-mapped binary trace.
+ *              Reports the throughput of each in events per second.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdexcept>
+#include "ArrivalReader.h"
+#include "BinaryTrace.h"
+
+using namespace std;
+
+// Reads every arrival of a source, returns the number read.
+// The checksum keeps the compiler from dropping the reads.
+unsigned long long drain(ArrivalReader &arrivals, long long &checksum) {
+    unsigned long long count = 0;
+    Event newEvent;
+    while (arrivals.next(newEvent)) {
+        checksum += newEvent.getTime() ^ newEvent.getLength();
+        count++;
+    }
+    return count;
+}
+
+// Prints one result line
+void report(const string &name, unsigned long long count, double seconds) {
+    cout << name << ": " << count << " events in " << seconds << " s, "
+         << (seconds > 0 ? count / seconds : 0) << " events/s" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        cerr << "Usage: " << argv[0] << " trace.txt" << endl;
+        return 1;
+    }
+    string textTrace = argv[1];
+    string binaryTrace = textTrace + ".bin";
+    long long checksum = 0;
+
+    try {
+        // Convert once, outside of the timed sections
+        {
+            ifstream input(textTrace);
+            TextArrivalReader textReader(input);
+            BinaryTraceWriter writer(binaryTrace);
+            Event newEvent;
+            while (textReader.next(newEvent))
+                writer.write(newEvent);
+            writer.close();
+        }
+
+        ifstream input(textTrace);
+        if (!input)
+            throw runtime_error("could not open " + textTrace);
+        TextArrivalReader textReader(input);
+        auto start = chrono::steady_clock::now();
+        unsigned long long textCount = drain(textReader, checksum);
+        chrono::duration<double> textTime = chrono::steady_clock::now() - start;
+
+        int descriptor = open(textTrace.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            throw runtime_error("could not open " + textTrace);
+        start = chrono::steady_clock::now();
+        unsigned long long fastCount;
+        {
+            FastTextArrivalReader fastReader(descriptor);
+            fastCount = drain(fastReader, checksum);
+        }
+        chrono::duration<double> fastTime = chrono::steady_clock::now() - start;
+        close(descriptor);
+
+        start = chrono::steady_clock::now();
+        MappedTraceReader traceReader(binaryTrace);
+        unsigned long long binaryCount = drain(traceReader, checksum);
+        chrono::duration<double> binaryTime = chrono::steady_clock::now() - start;
+
+        report("text (stringstream)", textCount, textTime.count());
+        report("text (block parser)", fastCount, fastTime.count());
+        report("binary (mmap)      ", binaryCount, binaryTime.count());
+        cout << "speedup over stringstream: block parser " << textTime.count() / fastTime.count()
+             << "x, binary " << textTime.count() / binaryTime.count() << "x (checksum " << checksum << ")" << endl;
+    }
+    catch (runtime_error &anException) {
+        cerr << anException.what() << endl;
+        remove(binaryTrace.c_str());
+        return 1;
+    }
+    remove(binaryTrace.c_str());
+    return 0;
+}
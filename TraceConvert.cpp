@@ -0,0 +1,77 @@
+/*
+ * TraceConvert.cpp
+ *
+ * Description: Converts a text trace ("time length" per line, optionally followed
+ *              by "teller class") read from standard input into a binary trace.
+ *              Lines are parsed as bsim parses them (FastTextArrivalReader): a
+ *              malformed line stops the conversion with its line number and no
+ *              output file is left behind.
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include "ArrivalReader.h"
+#include "BinaryTrace.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    uint32_t fields = 0;
+    string fileName = "";
+    bool validUsage = true;
+
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--teller-class")
+            fields |= BinaryTrace::FIELD_TELLER_CLASS;
+        else if (fileName.empty() && option[0] != '-')
+            fileName = option;
+        else
+            validUsage = false;
+    }
+    if (!validUsage || fileName.empty()) {
+        cerr << "Usage: " << argv[0] << " [--teller-class] output.bin < input.txt" << endl;
+        return 1;
+    }
+
+    bool created = false;
+    try {
+        BinaryTraceWriter writer(fileName, fields);
+        created = true;
+        FastTextArrivalReader reader;
+        BinaryTrace::Record record = { 0, 0, 0, 0 };
+        uint64_t count = 0;
+
+        if (fields & BinaryTrace::FIELD_TELLER_CLASS) {
+            int time, length, teller, customerClass;
+            while (reader.nextWithTellerClass(time, length, teller, customerClass)) {
+                record.time = time;
+                record.length = length;
+                record.teller = teller;
+                record.customerClass = customerClass;
+                writer.write(record);
+                count++;
+            }
+        }
+        else {
+            Event newEvent;
+            while (reader.next(newEvent)) {
+                record.time = newEvent.getTime();
+                record.length = newEvent.getLength();
+                writer.write(record);
+                count++;
+            }
+        }
+        writer.close();
+        cout << "Converted " << count << " arrivals into " << fileName << endl;
+    }
+    catch (runtime_error &anException) {
+        cerr << anException.what() << endl;
+        if (created)
+            remove(fileName.c_str());
+        return 1;
+    }
+    return 0;
+}
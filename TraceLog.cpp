@@ -0,0 +1,107 @@
+/*
+ * TraceLog.cpp
+ *
+ * Description: Buffered log of the events processed by the simulation.
+ *              Lines are formatted into a large buffer that is written out
+ *              when full, so the event loop never flushes per event.
+ *              In FULL mode the text is identical to logging every event
+ *              with cout << ... << endl.
+ *
+ * Class Invariant: Everything logged reaches the output stream, in order,
+ *                  by the time flush() returns or the log is destroyed.
+ */
+
+#include <cstring>
+#include "TraceLog.h"
+#include "Instrumentation.h"
+
+static char const ARRIVAL_PREFIX[] = "Processing an arrival event at time:";
+static char const DEPARTURE_PREFIX[] = "Processing a departure event at time:";
+
+
+// Description: Constructor
+TraceLog::TraceLog(std::ostream &anOutput, Mode aMode, unsigned int aSampleEvery)
+    : output(anOutput), mode(aMode), sampleEvery(aSampleEvery == 0 ? 1 : aSampleEvery) {
+    buffer = (mode == SUMMARY) ? nullptr : new char[BUFFER_SIZE];   // Nothing to buffer in SUMMARY mode
+}
+
+// Description: Destructor, flushes the log.
+TraceLog::~TraceLog() {
+    flush();
+    delete[] buffer;
+}
+
+// Description: Returns true if individual events are logged at all.
+bool TraceLog::isTracing() const {
+    return mode != SUMMARY;
+}
+
+// Description: Logs an arrival processed at time.
+void TraceLog::arrival(int time) {
+    BSIM_PHASE(LOG);
+    event(ARRIVAL_PREFIX, sizeof(ARRIVAL_PREFIX) - 1, 6, time);
+}
+
+// Description: Logs a departure processed at time.
+void TraceLog::departure(int time) {
+    BSIM_PHASE(LOG);
+    event(DEPARTURE_PREFIX, sizeof(DEPARTURE_PREFIX) - 1, 5, time);
+}
+
+// Description: Logs "<prefix><time right aligned in width>\n".
+void TraceLog::event(const char *prefix, unsigned int prefixLength, unsigned int width, int time) {
+    if (mode == SUMMARY)
+        return;
+    if (mode == SAMPLED) {
+        if (untilSample > 0) {
+            untilSample--;
+            return;
+        }
+        untilSample = sampleEvery - 1;
+    }
+
+    if (used + MAX_LINE > BUFFER_SIZE)
+        writeBuffer();
+
+    // Digits of time, backwards
+    char digits[12];
+    unsigned int count = 0;
+    unsigned int magnitude = (time < 0) ? 0u - (unsigned int)time : (unsigned int)time;
+    do {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (time < 0)
+        digits[count++] = '-';
+
+    char *line = buffer + used;
+    memcpy(line, prefix, prefixLength);
+    line += prefixLength;
+    for (unsigned int pad = count; pad < width; pad++)
+        *line++ = ' ';
+    while (count > 0)
+        *line++ = digits[--count];
+    *line++ = '\n';
+    used = line - buffer;
+}
+
+// Description: Logs a line of text (without its end of line), whatever the mode.
+void TraceLog::message(const std::string &text) {
+    BSIM_PHASE(LOG);
+    writeBuffer();
+    output << text << '\n';
+}
+
+// Description: Writes the buffered lines to the output stream.
+void TraceLog::flush() {
+    BSIM_PHASE(LOG);
+    writeBuffer();
+}
+
+// Description: Writes the buffered lines to the output stream (untimed, see flush()).
+void TraceLog::writeBuffer() {
+    if (used > 0) {
+        output.write(buffer, used);
+        used = 0;
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * TraceLog.h
+ *
+ * Description: Buffered log of the events processed by the simulation.
+ *              Lines are formatted into a large buffer that is written out
+ *              when full, so the event loop never flushes per event.
+ *              In FULL mode the text is identical to logging every event
+ *              with cout << ... << endl.
+ *
+ * Class Invariant: Everything logged reaches the output stream, in order,
+ *                  by the time flush() returns or the log is destroyed.
+ */
+
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <ostream>
+#include <string>
+
+class TraceLog {
+
+    public:
+        enum Mode { FULL, SAMPLED, SUMMARY };   // Every event, every n-th event, no events
+
+    private:
+        static unsigned int const BUFFER_SIZE = 1 << 20;   // Bytes buffered before writing out
+        static unsigned int const MAX_LINE = 64;           // Longest line event() formats
+
+        std::ostream &output;
+        Mode mode;
+        unsigned int sampleEvery;          // SAMPLED: log one event out of sampleEvery
+        unsigned int untilSample = 0;      // Events left to skip before the next sampled one
+        char *buffer;
+        unsigned int used = 0;             // Bytes of buffer in use
+
+        // Description: Logs "<prefix><time right aligned in width>\n".
+        void event(const char *prefix, unsigned int prefixLength, unsigned int width, int time);
+
+        // Description: Writes the buffered lines to the output stream.
+        void writeBuffer();
+
+    public:
+        // Description: Constructor
+        TraceLog(std::ostream &anOutput, Mode aMode = FULL, unsigned int aSampleEvery = 1);
+
+        // Description: Destructor, flushes the log.
+        ~TraceLog();
+
+        // Description: Returns true if individual events are logged at all.
+        bool isTracing() const;
+
+        // Description: Logs an arrival processed at time.
+        void arrival(int time);
+
+        // Description: Logs a departure processed at time.
+        void departure(int time);
+
+        // Description: Logs a line of text (without its end of line), whatever the mode.
+        void message(const std::string &text);
+
+        // Description: Writes the buffered lines to the output stream.
+        void flush();
+};
+#endif
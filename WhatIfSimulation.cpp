@@ -0,0 +1,193 @@
+/*
+ * WhatIfSimulation.cpp
+ *
+ * Description: A simulation that can be edited after it has run: each edit
+ *              resumes from the last snapshot before it and stops as soon as
+ *              the run reconverges with the run before the edit
+ *              (see WhatIfSimulation.h).
+ *
+ * Class Invariant: snapshots[k] begins parts[k]; the snapshots are in increasing
+ *                  order of the arrivals processed, the first one at none.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "WhatIfSimulation.h"
+#include "Checkpoint.h"
+#include "Instrumentation.h"
+
+
+// Description: Constructor, a snapshot every aSnapshotEvery arrivals.
+WhatIfSimulation::WhatIfSimulation(unsigned int aNumberOfTellers, Simulation::LineDiscipline aDiscipline,
+                                   Simulation::Scheduler aScheduler, bool anEventDriven, size_t aSnapshotEvery)
+    : numberOfTellers(aNumberOfTellers), discipline(aDiscipline), scheduler(aScheduler),
+      eventDriven(anEventDriven), snapshotEvery(aSnapshotEvery == 0 ? 1 : aSnapshotEvery),
+      statistics(aNumberOfTellers) { }
+
+// Description: Simulates from the last snapshot at or before arrivals[edited] until
+//              the run reconverges with the one before the edit, or to the end.
+//     The simulation is driven one arrival at a time (Simulation::begin()), so a
+//     snapshot is taken between an arrival and the next, as a checkpoint is. The
+//     snapshots of the run before the edit that come after it are compared where
+//     they fall in the edited arrivals; in between, a snapshot is taken every
+//     snapshotEvery arrivals (e.g. among arrivals inserted). Once a snapshot is the
+//     same, the parts and snapshots of the run before the edit are kept from there.
+void WhatIfSimulation::simulateFrom(size_t edited, long long shift) {
+    BSIM_PHASE(RUN);
+    size_t start = 0;
+    while (start + 1 < snapshots.size() && snapshots[start + 1].arrival <= edited)
+        start++;
+
+    // The run before the edit, from the snapshot on
+    std::vector<Snapshot> oldSnapshots(std::make_move_iterator(snapshots.begin() + start + 1),
+                                       std::make_move_iterator(snapshots.end()));
+    std::vector<SimulationStatistics> oldParts(parts.begin() + start, parts.end());
+    snapshots.erase(snapshots.begin() + start + 1, snapshots.end());
+    parts.erase(parts.begin() + start, parts.end());
+
+    std::unique_ptr<Simulation> simulation(
+        eventDriven ? Simulation::createEventDriven(numberOfTellers, discipline, scheduler)
+                    : Simulation::create(numberOfTellers, discipline, scheduler));
+    CheckpointReader snapshot(snapshots[start].state, "snapshot");
+    simulation->restoreState(snapshot, snapshots[start].arrival);
+    simulation->begin();
+
+    size_t first = snapshots[start].arrival;
+    size_t next = 0;                    // Next snapshot of the run before the edit to compare with
+    reconverged = false;
+    for (size_t i = first; i < arrivals.size(); ) {
+        simulation->addArrival(arrivals[i]);
+        while (simulation->step()) { }
+        i++;
+
+        while (next < oldSnapshots.size() && (long long)oldSnapshots[next].arrival + shift < (long long)i)
+            next++;
+        bool comparable = next < oldSnapshots.size() && (long long)oldSnapshots[next].arrival + shift == (long long)i;
+        if (!comparable && i - snapshots.back().arrival < snapshotEvery)
+            continue;
+
+        parts.push_back(simulation->splitStatistics());
+        CheckpointWriter state;
+        simulation->saveState(state);
+        if (comparable && state.getBytes() == oldSnapshots[next].state) {
+            // Reconverged: from here on, the run is the run before the edit
+            for (size_t k = next; k < oldSnapshots.size(); k++) {
+                oldSnapshots[k].arrival += shift;
+                snapshots.push_back(std::move(oldSnapshots[k]));
+            }
+            parts.insert(parts.end(), oldParts.begin() + next + 1, oldParts.end());
+            reconverged = true;
+            resimulatedCount = i - first;
+            break;
+        }
+        Snapshot newSnapshot;
+        newSnapshot.arrival = i;
+        newSnapshot.state = state.getBytes();
+        snapshots.push_back(std::move(newSnapshot));
+    }
+    if (!reconverged) {
+        simulation->finish();
+        parts.push_back(simulation->splitStatistics());
+        resimulatedCount = arrivals.size() - first;
+    }
+
+    statistics = parts[0];
+    for (size_t k = 1; k < parts.size(); k++)
+        statistics.merge(parts[k]);
+}
+
+// Description: Checks that customer is one of the arrivals.
+void WhatIfSimulation::checkCustomer(size_t customer) const {
+    if (customer >= arrivals.size())
+        throw std::runtime_error("there is no customer " + std::to_string(customer + 1)
+                                 + " among " + std::to_string(arrivals.size()));
+}
+
+// Description: Reads every arrival of someArrivals and simulates them, taking snapshots.
+//              The first snapshot is that of the simulation before any arrival.
+void WhatIfSimulation::run(ArrivalReader &someArrivals) {
+    {
+        BSIM_PHASE(PARSE);
+        arrivals.clear();
+        Event newArrivalEvent;
+        while (someArrivals.next(newArrivalEvent))
+            arrivals.push_back(newArrivalEvent);
+    }
+
+    std::unique_ptr<Simulation> simulation(
+        eventDriven ? Simulation::createEventDriven(numberOfTellers, discipline, scheduler)
+                    : Simulation::create(numberOfTellers, discipline, scheduler));
+    CheckpointWriter state;
+    simulation->saveState(state);
+    snapshots.clear();
+    parts.clear();
+    Snapshot initial;
+    initial.arrival = 0;
+    initial.state = state.getBytes();
+    snapshots.push_back(std::move(initial));
+    simulateFrom(0, 0);
+}
+
+// Description: Changes the transaction length of customer and updates the statistics.
+void WhatIfSimulation::setLength(size_t customer, int length) {
+    checkCustomer(customer);
+    arrivals[customer] = Event(Event::ARRIVAL, arrivals[customer].getTime(), length);
+    simulateFrom(customer, 0);
+}
+
+// Description: Inserts an arrival at time, after those at the same time, and
+//              updates the statistics.
+void WhatIfSimulation::insertArrival(int time, int length) {
+    Event newArrivalEvent(Event::ARRIVAL, time, length);
+    std::vector<Event>::iterator position = std::upper_bound(arrivals.begin(), arrivals.end(), newArrivalEvent,
+        [](const Event &lhs, const Event &rhs) { return lhs.getTime() < rhs.getTime(); });
+    size_t customer = position - arrivals.begin();
+    arrivals.insert(position, newArrivalEvent);
+    simulateFrom(customer, 1);
+}
+
+// Description: Removes customer and updates the statistics.
+void WhatIfSimulation::removeArrival(size_t customer) {
+    checkCustomer(customer);
+    arrivals.erase(arrivals.begin() + customer);
+    simulateFrom(customer, -1);
+}
+
+// Description: Returns the number of customers.
+long long WhatIfSimulation::getCustomerCount() const {
+    return arrivals.size();
+}
+
+// Description: Returns the arrival of customer.
+const Event & WhatIfSimulation::getArrival(size_t customer) const {
+    return arrivals[customer];
+}
+
+// Description: Returns the sum of the time customers spent waiting in line.
+long long WhatIfSimulation::getTotalWait() const {
+    return statistics.getWait().getTotal();
+}
+
+// Description: Returns the statistics of the run, as edited.
+const SimulationStatistics & WhatIfSimulation::getStatistics() const {
+    return statistics;
+}
+
+// Description: Returns the number of arrivals the last run or edit simulated.
+size_t WhatIfSimulation::getResimulatedCount() const {
+    return resimulatedCount;
+}
+
+// Description: Returns true if the last edit stopped where the run reconverged.
+bool WhatIfSimulation::hasReconverged() const {
+    return reconverged;
+}
+
+// Description: Returns the number of snapshots kept.
+size_t WhatIfSimulation::getSnapshotCount() const {
+    return snapshots.size();
+}
@@ -0,0 +1,124 @@
+/*
+ * WhatIfSimulation.h
+ *
+ * Description: A simulation that can be edited after it has run: change the
+ *              transaction length of a customer, insert an arrival or remove one,
+ *              and get the statistics of the edited day without simulating all
+ *              of it again.
+ *              The run keeps the arrivals and, every so many arrivals, a snapshot
+ *              of its state (Simulation::saveState(): clock, teller loads, pending
+ *              departures and lines; a few bytes per customer in the bank). The
+ *              statistics are split at every snapshot into parts that are merged
+ *              for the whole run.
+ *              An edit resumes from the last snapshot before it and simulates
+ *              from there, taking its own snapshots where the run took them, and
+ *              compares each with the one of the run before the edit: once they
+ *              are the same (typically once the tellers have gone idle with the
+ *              same departures pending) the rest of the run cannot differ, so it
+ *              stops and reuses the snapshots and parts of the run from there on.
+ *              An edit costs the arrivals from the snapshot before it to the point
+ *              the run reconverges, not the whole day.
+ *              The parts are merged with Chan et al.'s update, so the mean and
+ *              deviation of the waits may differ from those of a single pass in
+ *              the last digits; counts, totals, maxima, quantiles and time
+ *              averages are exact.
+ *
+ * Class Invariant: snapshots[k] begins parts[k]; the snapshots are in increasing
+ *                  order of the arrivals processed, the first one at none.
+ */
+
+#ifndef WHAT_IF_SIMULATION_H
+#define WHAT_IF_SIMULATION_H
+
+#include <vector>
+#include "Event.h"
+#include "ArrivalReader.h"
+#include "Simulation.h"
+#include "Statistics.h"
+
+class WhatIfSimulation {
+
+    private:
+        // The state of the run once a number of arrivals have been processed
+        struct Snapshot {
+            size_t arrival;                  // Arrivals processed: the next one is arrivals[arrival]
+            std::vector<char> state;         // Simulation::saveState(), the statistics just split
+        };
+
+        unsigned int numberOfTellers;
+        Simulation::LineDiscipline discipline;
+        Simulation::Scheduler scheduler;
+        bool eventDriven;                    // Never take the analytic fast path
+        size_t snapshotEvery;                // Arrivals between two snapshots
+        std::vector<Event> arrivals;         // Sorted by time
+        std::vector<Snapshot> snapshots;
+        std::vector<SimulationStatistics> parts;   // Statistics from each snapshot to the next, or the end
+        SimulationStatistics statistics;     // The parts merged
+        size_t resimulatedCount = 0;         // Arrivals the last run or edit simulated
+        bool reconverged = false;            // The last edit stopped where the run reconverged
+
+        // Description: Simulates from the last snapshot at or before arrivals[edited]
+        //              until the run reconverges with the one before the edit, whose
+        //              arrivals from edited on are shifted by shift, or to the end.
+        void simulateFrom(size_t edited, long long shift);
+
+        // Description: Checks that customer is one of the arrivals.
+        void checkCustomer(size_t customer) const;
+
+    public:
+        static size_t const DEFAULT_SNAPSHOT_EVERY = 4096;
+
+        // Description: Constructor, a snapshot every aSnapshotEvery arrivals.
+        WhatIfSimulation(unsigned int aNumberOfTellers = 1,
+                         Simulation::LineDiscipline aDiscipline = Simulation::SHARED_LINE,
+                         Simulation::Scheduler aScheduler = Simulation::BINARY_HEAP,
+                         bool anEventDriven = false, size_t aSnapshotEvery = DEFAULT_SNAPSHOT_EVERY);
+
+        // Description: Reads every arrival of someArrivals and simulates them, taking snapshots.
+        // Precondition: someArrivals are sorted by time.
+        // Exceptions: Throws runtime_error if the arrivals are not sorted by time,
+        //             and whatever someArrivals throws when it cannot be read.
+        // Time Efficiency: O(n log n) in the number of arrivals, as Simulation::run()
+        void run(ArrivalReader &someArrivals);
+
+        // Description: Changes the transaction length of customer (counting from 0, in
+        //              arrival order) and updates the statistics.
+        // Exceptions: Throws runtime_error if there is no such customer.
+        // Time Efficiency: O(k log k) in the arrivals from the snapshot before the edit
+        //                  to where the run reconverges
+        void setLength(size_t customer, int length);
+
+        // Description: Inserts an arrival at time, after those at the same time, and
+        //              updates the statistics.
+        // Time Efficiency: As setLength(), plus O(n) to insert it
+        void insertArrival(int time, int length);
+
+        // Description: Removes customer and updates the statistics.
+        // Exceptions: Throws runtime_error if there is no such customer.
+        // Time Efficiency: As insertArrival()
+        void removeArrival(size_t customer);
+
+        // Description: Returns the number of customers.
+        long long getCustomerCount() const;
+
+        // Description: Returns the arrival of customer.
+        // Precondition: customer < getCustomerCount()
+        const Event &getArrival(size_t customer) const;
+
+        // Description: Returns the sum of the time customers spent waiting in line.
+        long long getTotalWait() const;
+
+        // Description: Returns the statistics of the run, as edited.
+        const SimulationStatistics &getStatistics() const;
+
+        // Description: Returns the number of arrivals the last run or edit simulated.
+        size_t getResimulatedCount() const;
+
+        // Description: Returns true if the last edit stopped where the run reconverged
+        //              with the run before it, rather than at the end of the arrivals.
+        bool hasReconverged() const;
+
+        // Description: Returns the number of snapshots kept.
+        size_t getSnapshotCount() const;
+};
+#endif
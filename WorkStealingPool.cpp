@@ -0,0 +1,127 @@
+/*
+ * WorkStealingPool.cpp
+ *
+ * Description: Runs a batch of independent tasks on a fixed number of worker
+ *              threads, each with its own deque of tasks, stealing from the
+ *              others once its own deque is empty (see WorkStealingPool.h).
+ *
+ * Class Invariant: Every submitted task runs exactly once, on one worker.
+ */
+
+#include <thread>
+#include <utility>
+#include "WorkStealingPool.h"
+
+
+// Description: Constructor, numberOfWorkers threads (at least 1) will run the tasks.
+WorkStealingPool::WorkStealingPool(unsigned int numberOfWorkers) : nextWorker(0), pending(0), submitted(0) {
+    if (numberOfWorkers == 0)
+        numberOfWorkers = 1;
+    for (unsigned int i = 0; i < numberOfWorkers; i++)
+        workers.emplace_back(new Worker());
+}
+
+// Description: Returns the number of workers.
+unsigned int WorkStealingPool::getWorkerCount() const {
+    return workers.size();
+}
+
+// Description: Adds aTask to the deques of the workers, in turn, and wakes an idle worker.
+//              It is pending before it is queued, so it cannot finish before it counts.
+void WorkStealingPool::submit(Task aTask) {
+    {
+        std::lock_guard<std::mutex> guard(idleLock);
+        pending++;
+    }
+    {
+        Worker &worker = *workers[nextWorker++ % workers.size()];
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.tasks.push_back(std::move(aTask));
+    }
+    {
+        std::lock_guard<std::mutex> guard(idleLock);
+        submitted++;
+    }
+    idle.notify_one();
+}
+
+// Description: Takes the next task of worker from the front of its deque; if it is empty,
+//              steals the last task of the next worker that has one.
+bool WorkStealingPool::take(unsigned int worker, Task &task) {
+    {
+        Worker &own = *workers[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    for (unsigned int i = 1; i < workers.size(); i++) {
+        Worker &victim = *workers[(worker + i) % workers.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Description: Runs tasks on worker until every submitted task has finished.
+//              A worker with nothing to take sleeps until a task is queued after
+//              it looked (the tasks still running may submit more) or the last
+//              task finishes.
+void WorkStealingPool::work(unsigned int worker) {
+    Task task;
+    while (true) {
+        unsigned long long seen;
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            if (pending == 0)
+                return;
+            seen = submitted;
+        }
+        if (!take(worker, task)) {
+            std::unique_lock<std::mutex> guard(idleLock);
+            idle.wait(guard, [this, seen] { return pending == 0 || submitted != seen; });
+            continue;
+        }
+        try {
+            task(worker);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error)
+                error = std::current_exception();
+        }
+        task = nullptr;
+
+        bool finished;
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            finished = --pending == 0;
+        }
+        if (finished)
+            idle.notify_all();
+    }
+}
+
+// Description: Runs every submitted task and returns once all have finished.
+//              The calling thread is worker 0.
+void WorkStealingPool::run() {
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < workers.size(); i++)
+        threads.emplace_back(&WorkStealingPool::work, this, i);
+    work(0);      // This thread works too
+    for (unsigned int i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    if (error) {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * WorkStealingPool.h
+ *
+ * Description: Runs a batch of independent tasks on a fixed number of worker
+ *              threads. Every worker has its own deque of tasks: it takes its
+ *              own tasks from the front, in the order they were submitted, and
+ *              once it runs out it steals from the back of another worker's
+ *              deque. Submitting the longest tasks first therefore starts them
+ *              first, while the short tasks at the back even out the finish.
+ *              A task is told which worker runs it, so it can use per-worker
+ *              state (e.g. a MonotonicArena) without locking.
+ *              A worker with nothing to take sleeps until a task is submitted
+ *              or the last one finishes, rather than spinning.
+ *
+ * Class Invariant: Every submitted task runs exactly once, on one worker.
+ */
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class WorkStealingPool {
+
+    public:
+        typedef std::function<void(unsigned int worker)> Task;
+
+    private:
+        // The deque of one worker, locked by its owner and by thieves alike
+        struct Worker {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<unsigned int> nextWorker;   // Deque the next submit() goes to (modulo the workers)
+        std::mutex idleLock;                    // Guards pending and submitted
+        std::condition_variable idle;           // Signalled when a task is queued or the last one finishes
+        unsigned long long pending;             // Tasks submitted but not finished
+        unsigned long long submitted;           // Tasks queued so far, for an idle worker to see new ones
+        std::mutex errorLock;
+        std::exception_ptr error;               // First exception a task threw
+
+        // Description: Takes the next task of worker, or steals one. Returns false if there is none.
+        bool take(unsigned int worker, Task &task);
+
+        // Description: Runs tasks on worker until every submitted task has finished.
+        void work(unsigned int worker);
+
+    public:
+        // Description: Constructor, numberOfWorkers threads (at least 1) will run the tasks.
+        WorkStealingPool(unsigned int numberOfWorkers);
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool & operator=(const WorkStealingPool &) = delete;
+
+        // Description: Returns the number of workers.
+        unsigned int getWorkerCount() const;
+
+        // Description: Adds aTask to the deques of the workers, in turn.
+        //              Tasks may also submit further tasks while run() is going.
+        void submit(Task aTask);
+
+        // Description: Runs every submitted task and returns once all have finished.
+        //              The calling thread is worker 0.
+        // Exceptions: Rethrows the first exception a task threw, after all tasks have finished.
+        void run();
+};
+#endif